@@ -0,0 +1,136 @@
+// 压测框架热路径的微基准 (Google Benchmark)
+//
+// 覆盖 BenchmarkRunner 每个请求都会经过的操作：取时间戳、记录延迟、抢单派发、
+// 引擎虚调用，以及监控线程的 /proc 采样。运行：./bin/harness_bench
+#include <benchmark/benchmark.h>
+#include "LatencyHistogram.h"
+#include "NullEngine.h"
+#include "SystemMonitor.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// --- 计时 ---
+
+static void BM_HighResolutionClockNow(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::high_resolution_clock::now());
+    }
+}
+BENCHMARK(BM_HighResolutionClockNow);
+
+static void BM_SteadyClockNow(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+    }
+}
+BENCHMARK(BM_SteadyClockNow);
+
+// 一次延迟测量：两次取时间戳 + duration_cast
+static void BM_TimedInterval(benchmark::State& state) {
+    for (auto _ : state) {
+        auto t1 = std::chrono::steady_clock::now();
+        auto t2 = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+    }
+}
+BENCHMARK(BM_TimedInterval);
+
+// --- 延迟记录 ---
+
+// BenchmarkRunner 的做法：每个线程一个 vector<double>，未预留容量
+static void BM_RecordLatencyVector(benchmark::State& state) {
+    std::vector<double> latencies;
+    double value = 1.234;
+    for (auto _ : state) {
+        latencies.push_back(value);
+        if (latencies.size() >= 1u << 20) {
+            state.PauseTiming();
+            latencies = std::vector<double>();
+            state.ResumeTiming();
+        }
+    }
+    benchmark::DoNotOptimize(latencies.data());
+}
+BENCHMARK(BM_RecordLatencyVector);
+
+// ProcessRunner / LoadClient 的做法：定长直方图
+static void BM_RecordLatencyHistogram(benchmark::State& state) {
+    std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+    histogram->Reset();
+    uint64_t value = 123456;
+    for (auto _ : state) {
+        histogram->Record(value);
+        value = (value * 1103515245u + 12345u) & 0xffffff; // 分散到不同的桶
+    }
+    benchmark::DoNotOptimize(histogram->total_count);
+}
+BENCHMARK(BM_RecordLatencyHistogram);
+
+// --- 派发 ---
+
+// 抢单：所有 Worker 争用同一个原子计数器
+static std::atomic<int> g_remaining_requests(0);
+
+static void BM_AtomicDispatch(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(g_remaining_requests.fetch_sub(1));
+    }
+}
+BENCHMARK(BM_AtomicDispatch)->ThreadRange(1, 16)->UseRealTime();
+
+// --- 引擎调用 ---
+
+static void BM_NullEngineRun(benchmark::State& state) {
+    std::unique_ptr<Engine> engine(new NullEngine(state.range(0))); // 与 BenchmarkRunner 一样经虚函数调用
+    std::vector<float> input(engine->GetInputSize(), 0.5f);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine->Run(input));
+    }
+}
+BENCHMARK(BM_NullEngineRun)->Arg(1)->Arg(1024)->Arg(150528);
+
+// 完整的单请求路径：抢单 + 计时 + 空推理 + 记录
+static void BM_HarnessRequest(benchmark::State& state) {
+    std::unique_ptr<Engine> engine(new NullEngine(1024));
+    std::vector<float> input(engine->GetInputSize(), 0.5f);
+    std::vector<double> latencies;
+    latencies.reserve(1u << 20);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(g_remaining_requests.fetch_sub(1));
+        auto t1 = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(engine->Run(input));
+        auto t2 = std::chrono::steady_clock::now();
+        if (latencies.size() == latencies.capacity()) latencies.clear();
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e6);
+    }
+}
+BENCHMARK(BM_HarnessRequest)->ThreadRange(1, 16)->UseRealTime();
+
+// --- /proc 采样 (监控线程每 100ms 一次) ---
+
+static void BM_ProcCpuUsage(benchmark::State& state) {
+    SystemMonitor monitor;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(monitor.GetCpuUsage());
+    }
+}
+BENCHMARK(BM_ProcCpuUsage);
+
+static void BM_ProcMemoryUsage(benchmark::State& state) {
+    SystemMonitor monitor;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(monitor.GetMemoryUsage());
+    }
+}
+BENCHMARK(BM_ProcMemoryUsage);
+
+static void BM_HeapInUseBytes(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SystemMonitor::GetHeapInUseBytes());
+    }
+}
+BENCHMARK(BM_HeapInUseBytes);
+
+BENCHMARK_MAIN();
@@ -1,7 +1,9 @@
 #pragma once
 
-#include "InferenceEngine.h"
+#include "Engine.h"
 #include "SystemMonitor.h"
+#include "CgroupWatchdog.h"
+#include <string>
 #include <vector>
 #include <cstdint>
 
@@ -10,9 +12,19 @@
  */
 struct BenchmarkConfig {
     int threads = 1;        ///< 并发线程数
+    int processes = 0;      ///< 多进程模式的 Worker 进程数 (由 ProcessRunner 使用)，0 表示线程模式
     int requests = 100;     ///< 总请求数
     int warmup_rounds = 10; ///< 预热轮数（不计入统计）
     double memory_limit_mb = 0.0; ///< 内存限制 (MB)，0 表示不限制
+    bool cgroup_watchdog = false; ///< 启用基于 cgroup v2 / PSI 的事件驱动看门狗
+    WatchdogOptions watchdog;     ///< cgroup 看门狗触发条件
+    WatchdogAction watchdog_action = WatchdogAction::kStopAdmission; ///< 看门狗触发后的处置策略
+    std::string trace_path;           ///< Chrome Trace 输出路径，为空表示不记录 Span
+    size_t trace_capacity = 100000;   ///< 每个 Worker 保留的最大 Span 数 (环形缓冲区)
+    std::string request_log_path;     ///< 二进制逐请求日志路径，为空表示不记录
+    double deadline_ms = 0.0;   ///< 每个请求的截止时间 (毫秒，自到达时刻起算)，0 表示不限制
+    double arrival_rate = 0.0;  ///< 开环到达速率 (请求/秒，泊松到达)，0 表示闭环抢单
+    int harness_calibration_requests = 20000; ///< 压测后用 NullEngine 标定框架开销的请求数 (不超过 requests)，0 表示不标定
 };
 
 /**
@@ -24,6 +36,62 @@ struct BenchmarkResult {
     double p99_latency_ms = 0.0; ///< P99 延迟 (毫秒)
     double avg_cpu_usage = 0.0;  ///< 平均 CPU 使用率 (%)
     double peak_memory_mb = 0.0; ///< 峰值内存占用 (MB)
+    int completed_requests = 0;  ///< 实际完成的请求数 (看门狗介入时可能少于配置值)
+    int failed_requests = 0;     ///< 推理抛出异常的请求数 (不含超时取消)
+
+    // --- 看门狗 ---
+    int watchdog_triggers = 0;   ///< 看门狗触发次数
+    bool aborted = false;        ///< 是否因 WatchdogAction::kAbort 中止
+    int final_concurrency = 0;   ///< 结束时的有效并发数 (kShrinkConcurrency 会降低该值)
+
+    // --- 截止时间与准入控制 (仅 deadline_ms > 0 时有效) ---
+    double goodput_qps = 0.0;    ///< 在截止时间内完成的请求吞吐量
+    int rejected_requests = 0;   ///< 准入控制拒绝的请求数
+    int timeout_requests = 0;    ///< 超时的请求数 (推理中被取消 + 完成时已超时)
+    double rejection_rate = 0.0; ///< 拒绝数 / 已派发请求数
+    double timeout_rate = 0.0;   ///< 超时数 / 已派发请求数
+    double avg_queue_ms = 0.0;   ///< 平均排队时长 (到达 -> 开始处理，开环模式下有意义)
+
+    // --- cgroup v2 (不可用时保持默认值) ---
+    bool cgroup_available = false;      ///< 是否读取到了 cgroup v2 数据
+    double cgroup_peak_memory_mb = 0.0; ///< memory.current 峰值 (含 page cache)
+    double cgroup_memory_max_mb = 0.0;  ///< memory.max，0 表示不限制
+    int64_t cgroup_oom_events = 0;      ///< 压测期间 memory.events 中 oom 的增量
+    double cpu_quota_cores = 0.0;       ///< cpu.max 配额核数，0 表示不限制
+    int64_t cpu_nr_throttled = 0;       ///< 压测期间被节流的周期数
+    double cpu_throttled_ms = 0.0;      ///< 压测期间被节流的总时长 (毫秒)
+    double cpu_throttled_ratio = 0.0;   ///< 被节流周期占比 (nr_throttled / nr_periods)
+
+    // --- 能耗与频率 (RAPL / cpufreq 不可用时保持默认值) ---
+    bool energy_available = false;     ///< 是否读取到了 RAPL 能耗
+    double energy_joules = 0.0;        ///< 压测期间 package 能耗 (整机口径)
+    double avg_power_watts = 0.0;      ///< 平均功率
+    double joules_per_inference = 0.0; ///< 每次推理能耗
+    double queries_per_joule = 0.0;    ///< 每焦耳完成的请求数
+    bool freq_available = false;       ///< 是否读取到了 cpufreq
+    double avg_freq_mhz = 0.0;         ///< 平均核频率
+    double min_freq_mhz = 0.0;         ///< 最低单核频率
+    int64_t throttle_events = 0;       ///< thermal_throttle 计数增量
+    int below_base_events = 0;         ///< 频率跌破基础频率的次数
+
+    // --- 内存行为 (ONNX Runtime 分配器) ---
+    double session_memory_mb = 0.0;      ///< 加载模型时的堆增量 (权重 + Session 状态)
+    double arena_peak_mb = 0.0;          ///< 推理激活内存峰值 (见 BenchmarkRunner::Run 的说明)
+    bool arena_peak_approximate = false; ///< arena_peak_mb 来自 malloc 堆高水位 (近似值) 而非计数分配器
+    double alloc_per_inference_kb = 0.0; ///< 每次推理经分配器分配的字节数 (仅 AllocatorMode::kTracking)
+
+    // --- 压测框架开销 (NullEngine 标定，未标定时为 0) ---
+    double harness_latency_us = 0.0;   ///< 空引擎下测得的单次延迟：每个延迟样本中都包含的计时与调用开销
+    double harness_request_us = 0.0;   ///< 空引擎下每个 Worker 处理一个请求的墙钟时间 (派发 + 计时 + 记录)
+    double harness_overhead_pct = 0.0; ///< harness_request_us 占平均延迟的百分比
+};
+
+/**
+ * @brief 压测框架自身开销的标定结果
+ */
+struct HarnessOverhead {
+    double latency_us = 0.0; ///< 空引擎下的平均单次延迟 (微秒)
+    double request_us = 0.0; ///< 每个 Worker 处理一个请求的平均墙钟时间 (微秒)
 };
 
 /**
@@ -40,22 +108,56 @@ public:
      * @param engine 依赖的推理引擎 (引用，生命周期需长于 Runner)
      * @param monitor 依赖的系统监控器 (引用，生命周期需长于 Runner)
      */
-    BenchmarkRunner(InferenceEngine& engine, SystemMonitor& monitor);
+    BenchmarkRunner(Engine& engine, SystemMonitor& monitor);
     ~BenchmarkRunner() = default;
 
     /**
      * @brief 执行压测
      * 
      * 此函数是阻塞的，直到所有请求完成。
+     *
+     * 内存行为统计：AllocatorMode::kTracking 下 arena_peak_mb 取计数分配器的峰值减去
+     * 加载完成时的占用；其他模式下取预热及正式压测期间 (监控线程每 500ms 采样一次)
+     * malloc 堆的高水位减去预热前的占用，并扣除压测框架自身的缓冲区 (Trace、请求日志、延迟数组)。
+     * 这只是近似值 (arena_peak_approximate)：arena 不会归还内存，因此大致等于 arena 的峰值大小，
+     * 多线程时包含各并发推理各自的激活内存，也会混入框架在压测期间的少量其他分配。
+     *
+     * 截止时间 (config.deadline_ms > 0)：每个请求的截止时间 = 到达时刻 + deadline_ms。
+     * Worker 取到请求时，若“当前时刻 + 预估推理耗时 (EWMA，初值为预热耗时的中位数)”已超过
+     * 截止时间则直接拒绝；连续拒绝 16 个后放行一个截止时间未过的探测请求，用其实际耗时校正预估，
+     * 避免预估偏高时永远拒绝。
+     * 否则开始推理，由后台线程在截止时间到达时通过 CancelToken 取消仍在执行的推理
+     * (InferenceEngine 转为 Ort::RunOptions::SetTerminate()，NullEngine 在忙等中检查)。开环模式 (config.arrival_rate > 0) 下请求按泊松过程到达，
+     * Worker 跟不上时请求在到达后排队，排队时长计入截止时间。
+     *
+     * 框架开销 (config.harness_calibration_requests > 0)：压测结束后以相同的线程数、截止时间、
+     * Trace 与请求日志配置驱动 NullEngine 再跑 min(harness_calibration_requests, requests) 个请求，
+     * 结果写入 harness_* 字段。开环到达不参与标定 (等待到达的时间不属于框架开销)。
      * 
      * @param config 压测配置
      * @return BenchmarkResult 最终统计结果
      */
     BenchmarkResult Run(const BenchmarkConfig& config);
 
+    /**
+     * @brief 标定压测框架自身的开销
+     *
+     * 用 spin_ns = 0 的 NullEngine 按 config 的线程数、截止时间与记录配置执行 requests 个请求，
+     * 只计 Worker 取单循环的耗时。Trace 只记录不导出，请求日志写入
+     * "<request_log_path>.calibration" 并在结束后删除。
+     *
+     * @param config 主压测配置
+     * @param input_size 输入元素个数 (与主压测一致，保证输入拷贝等开销相同)
+     * @param requests 标定请求数
+     * @return HarnessOverhead 标定结果
+     */
+    HarnessOverhead MeasureHarnessOverhead(const BenchmarkConfig& config, int64_t input_size, int requests);
+
 private:
-    InferenceEngine& engine_;
+    Engine& engine_;
     SystemMonitor& monitor_;
+    bool calibrating_ = false;   ///< 标定用的内部 Runner：不导出 Trace、不打印日志落盘信息
+    int64_t worker_loop_ns_ = 0; ///< 最近一次 Run 中各 Worker 取单循环的耗时之和
 
     /**
      * @brief 计算延迟的百分位数
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief cgroup v2 内存统计快照
+ *
+ * 与 RSS 不同，memory.current 包含 page cache 与内核内存，
+ * 与容器被 OOM Kill 时内核使用的口径一致。
+ */
+struct CgroupMemoryStat {
+    int64_t current_bytes = 0;   ///< memory.current
+    int64_t max_bytes = -1;      ///< memory.max，-1 表示 "max" (不限制)
+    int64_t anon_bytes = 0;      ///< memory.stat: anon (匿名页)
+    int64_t file_bytes = 0;      ///< memory.stat: file (page cache)
+    int64_t events_high = 0;     ///< memory.events: high (超过 memory.high 被回收的次数)
+    int64_t events_max = 0;      ///< memory.events: max (触及 memory.max 的次数)
+    int64_t events_oom = 0;      ///< memory.events: oom
+    int64_t events_oom_kill = 0; ///< memory.events: oom_kill
+};
+
+/**
+ * @brief cgroup v2 CPU 统计快照 (cpu.stat)
+ *
+ * nr_throttled / throttled_usec 反映 CPU 配额 (cpu.max) 导致的节流，
+ * 这类节流不会体现在 /proc/stat 的使用率中，但会直接压低 QPS。
+ */
+struct CgroupCpuStat {
+    int64_t usage_usec = 0;     ///< 累计 CPU 时间
+    int64_t nr_periods = 0;     ///< 经历的配额周期数
+    int64_t nr_throttled = 0;   ///< 被节流的周期数
+    int64_t throttled_usec = 0; ///< 累计被节流时长
+};
+
+/**
+ * @brief 看门狗触发后的处置策略
+ */
+enum class WatchdogAction {
+    kStopAdmission,     ///< 停止派发新请求，已在执行的请求正常完成
+    kShrinkConcurrency, ///< 并发减半 (最低 1)，已为 1 时退化为停止派发
+    kAbort              ///< 立即停止并将本次结果标记为中止
+};
+
+/**
+ * @brief 看门狗配置
+ */
+struct WatchdogOptions {
+    double memory_ratio = 0.9;     ///< memory.current / memory.max 超过该比例即触发，<= 0 关闭
+    int psi_stall_us = 0;          ///< PSI 触发阈值：窗口内 "some" 停顿总时长 (us)，0 关闭
+    int psi_window_us = 1000000;   ///< PSI 窗口长度 (us)，内核要求 500ms ~ 10s
+    int poll_interval_ms = 100;    ///< 兜底轮询周期 (用于 memory_ratio 检查)
+};
+
+/**
+ * @brief 看门狗触发事件
+ */
+struct WatchdogEvent {
+    /// 触发来源
+    enum class Source {
+        kPsi,          ///< memory.pressure 上注册的 PSI 触发器
+        kMemoryEvents, ///< memory.events 中 high/max/oom 计数增长
+        kMemoryRatio   ///< memory.current 超过 memory.max 的给定比例
+    };
+    Source source = Source::kMemoryRatio;
+    CgroupMemoryStat memory; ///< 触发时刻的内存快照
+};
+
+/**
+ * @brief 基于 cgroup v2 的事件驱动内存看门狗
+ *
+ * 读取当前进程所在 cgroup 的 memory.* / cpu.* 接口文件，
+ * 并在 memory.pressure 上注册 PSI 触发器，由独立线程通过 poll() 阻塞等待，
+ * 内核在压力越过阈值时立即唤醒，而不依赖固定周期轮询 RSS。
+ *
+ * 在非 cgroup v2 环境 (如 v1 / hybrid 挂载) 下 IsAvailable() 返回 false，
+ * 所有读取接口返回默认值，调用方应退回到 SystemMonitor 的 RSS 检查。
+ */
+class CgroupWatchdog {
+public:
+    /// 触发回调，在看门狗线程中调用
+    using Callback = std::function<void(const WatchdogEvent&)>;
+
+    /**
+     * @brief 构造函数
+     *
+     * @param cgroup_dir cgroup 目录；为空时自动探测当前进程所在的 cgroup v2 目录
+     */
+    explicit CgroupWatchdog(const std::string& cgroup_dir = "");
+    ~CgroupWatchdog();
+
+    CgroupWatchdog(const CgroupWatchdog&) = delete;
+    CgroupWatchdog& operator=(const CgroupWatchdog&) = delete;
+
+    /**
+     * @brief 当前 cgroup 目录是否可用 (存在 cgroup v2 接口文件)
+     */
+    bool IsAvailable() const;
+
+    /**
+     * @brief 获取 cgroup 目录路径
+     */
+    const std::string& GetPath() const { return path_; }
+
+    /**
+     * @brief 读取 memory.current / memory.max / memory.stat / memory.events
+     */
+    CgroupMemoryStat ReadMemoryStat() const;
+
+    /**
+     * @brief 读取 cpu.stat
+     */
+    CgroupCpuStat ReadCpuStat() const;
+
+    /**
+     * @brief 读取 cpu.max 并换算为可用核数
+     *
+     * @return double 配额核数 (quota / period)，0 表示不限制或不可用
+     */
+    double GetCpuQuotaCores() const;
+
+    /**
+     * @brief 启动看门狗线程
+     *
+     * @param options 触发条件
+     * @param on_trigger 触发回调 (在看门狗线程中执行，不应长时间阻塞)
+     * @return true 启动成功；false 表示 cgroup 不可用或已在运行
+     */
+    bool Start(const WatchdogOptions& options, Callback on_trigger);
+
+    /**
+     * @brief 停止看门狗线程 (可重复调用)
+     */
+    void Stop();
+
+    /**
+     * @brief PSI 触发器是否已成功注册
+     *
+     * 注册失败 (内核不支持 PSI 或无写权限) 时看门狗仍会基于 memory.events 工作。
+     */
+    bool HasPsiTrigger() const { return psi_fd_ >= 0; }
+
+    /**
+     * @brief 探测当前进程所在的 cgroup v2 目录
+     *
+     * 解析 /proc/self/cgroup 中的 "0::<path>" 行，并结合 /proc/self/mountinfo
+     * 中 cgroup2 的挂载点拼接出完整路径。
+     *
+     * @return std::string 目录路径；非 cgroup v2 环境返回空串
+     */
+    static std::string DetectCgroupPath();
+
+private:
+    /// 看门狗线程主循环
+    void WatchLoop();
+
+    /// 读取 cgroup 目录下单个文件的全部内容，失败返回空串
+    std::string ReadFile(const char* name) const;
+
+    std::string path_;
+    WatchdogOptions options_;
+    Callback on_trigger_;
+
+    int psi_fd_ = -1;    // memory.pressure (注册触发器后保持打开)
+    int events_fd_ = -1; // memory.events (内核在计数变化时产生 POLLPRI)
+    int stop_fd_ = -1;   // eventfd，用于唤醒 poll 以退出线程
+
+    std::thread thread_;
+    std::mutex mutex_; // 保护 Start/Stop
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 冷启动测试配置
+ */
+struct ColdStartConfig {
+    int repetitions = 5;     ///< 重复次数 (每次重新加载模型)，用于统计稳定性
+    int first_requests = 20; ///< 每个阶段记录的前 N 个请求
+    int idle_ms = 0;         ///< 恢复阶段前的空闲时长 (毫秒)
+    bool flush_cache = false; ///< 恢复阶段前遍历大缓冲区，冲刷 CPU 缓存
+    size_t flush_bytes = 0;   ///< 冲刷缓冲区大小，0 表示自动 (末级缓存的 2 倍，限制在 64MB ~ 1GB)
+    bool evict_pages = false; ///< 加载前丢弃模型文件的 page cache；恢复阶段前对引擎新增的匿名内存 MADV_PAGEOUT (会固定 glibc 的 mmap 阈值)
+};
+
+/**
+ * @brief 均值 / 标准差 / 极值
+ */
+struct ColdStartStats {
+    double mean = 0.0;
+    double stddev = 0.0; ///< 样本标准差 (n - 1)
+    double min = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief 单次重复的原始数据
+ */
+struct ColdStartSample {
+    double load_ms = 0.0;              ///< 创建引擎 (加载模型) 耗时
+    std::vector<double> latencies_ms;  ///< 加载后前 N 个请求的延迟，[0] 即首次推理
+    std::vector<double> recovery_ms;   ///< 空闲 / 冲刷 / 换出后前 N 个请求的延迟 (未配置恢复阶段时为空)
+    int64_t evicted_bytes = 0;         ///< 恢复阶段前实际换出的匿名驻留字节数 (-1 表示内核不支持)
+};
+
+/**
+ * @brief 进程地址空间中的一段区间 [begin, end)
+ */
+struct AddressRange {
+    uintptr_t begin = 0;
+    uintptr_t end = 0;
+};
+
+/**
+ * @brief 冷启动测试结果
+ */
+struct ColdStartResult {
+    std::vector<ColdStartSample> samples; ///< 每次重复的原始数据
+    ColdStartStats load_ms;               ///< 加载耗时
+    ColdStartStats first_ms;              ///< 首次推理延迟
+    ColdStartStats recovery_first_ms;     ///< 恢复阶段首个请求的延迟
+    std::vector<double> curve_ms;          ///< 第 i 个请求在各次重复中的平均延迟
+    std::vector<double> recovery_curve_ms; ///< 恢复阶段第 i 个请求的平均延迟
+    double warm_ms = 0.0;                 ///< 稳态参考：curve_ms 后半段的平均值
+};
+
+/**
+ * @brief 冷启动与空闲恢复测试
+ *
+ * BenchmarkRunner 总是先预热再计时，测不到扩缩容到零后首个请求的真实体验。
+ * 本类每次重复都通过工厂重新创建引擎 (即重新加载模型)，单线程依次执行：
+ * 1. 计时加载 (evict_pages 时先丢弃模型文件的 page cache，使加载需要重新读盘)；
+ * 2. 记录前 N 个请求的延迟曲线，首个请求包含 ONNX Runtime 的首次分配与内存规划；
+ * 3. (可选) 空闲 idle_ms → 冲刷缓存 → 换出匿名内存，再记录前 N 个请求的恢复曲线。
+ *
+ * 换出只针对加载及前 N 个请求期间新增的匿名映射 (含堆的增长部分)，即模型权重与 arena，
+ * 不动进程中与引擎无关的内存；复用了已有空闲堆空间的分配不在其中。
+ *
+ * 注意：进程内第一次重复还包含 ONNX Runtime 全局初始化与代码页缺页，通常明显慢于之后的重复；
+ * MADV_PAGEOUT 需要 Linux 5.4+，且只有配置了 swap 时匿名页 (模型权重) 才会真正被换出。
+ */
+class ColdStartRunner {
+public:
+    using EngineFactory = std::function<std::unique_ptr<Engine>()>;
+
+    /**
+     * @brief 构造函数
+     *
+     * @param factory 创建并加载引擎的工厂，每次重复调用一次，其耗时即加载耗时
+     * @param model_path 模型文件路径 (仅用于丢弃 page cache，可为空)
+     */
+    explicit ColdStartRunner(EngineFactory factory, const std::string& model_path = "");
+
+    /**
+     * @brief 执行冷启动测试 (阻塞)
+     *
+     * @param config 测试配置
+     * @return ColdStartResult 汇总结果
+     * @throws 工厂抛出的异常 (如模型加载失败) 原样传出
+     */
+    ColdStartResult Run(const ColdStartConfig& config);
+
+    /**
+     * @brief 计算均值 / 样本标准差 / 极值，空输入返回全 0
+     */
+    static ColdStartStats Summarize(const std::vector<double>& values);
+
+    /**
+     * @brief 顺序读写 bytes 字节的缓冲区，把 CPU 缓存中的其他数据挤出去
+     *
+     * @param bytes 缓冲区大小，0 表示自动
+     */
+    static void FlushCaches(size_t bytes = 0);
+
+    /**
+     * @brief 丢弃文件在 page cache 中的页 (posix_fadvise DONTNEED，脏页不受影响)
+     *
+     * @return true 调用成功
+     */
+    static bool DropFileCache(const std::string& path);
+
+    /**
+     * @brief 读取本进程当前的可写私有匿名映射 (含堆) 区间，按地址升序
+     */
+    static std::vector<AddressRange> SnapshotAnonymousMappings();
+
+    /**
+     * @brief 求 after 中未被 before 覆盖的部分 (新增的映射与已有映射的增长部分)
+     *
+     * @param after 后一次快照 (按地址升序)
+     * @param before 前一次快照 (按地址升序)
+     */
+    static std::vector<AddressRange> SubtractRanges(const std::vector<AddressRange>& after,
+                                                    const std::vector<AddressRange>& before);
+
+    /**
+     * @brief 对给定区间调用 MADV_PAGEOUT
+     *
+     * 数据不会丢失，被换出的页在下次访问时缺页换入。
+     *
+     * @return int64_t 前后 /proc/self/smaps_rollup 中 Anonymous 的减少量 (实际换出的驻留字节数，
+     *         未配置 swap 时通常为 0)；内核不支持 MADV_PAGEOUT 时返回 -1
+     */
+    static int64_t EvictAnonymousPages(const std::vector<AddressRange>& ranges);
+
+private:
+    EngineFactory factory_;
+    std::string model_path_;
+};
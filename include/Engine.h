@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 计数分配器的统计数据 (仅 AllocatorMode::kTracking 下可用)
+ *
+ * 计数分配器由进程内所有使用它的 Session 共享，数据为进程级累计值。
+ */
+struct AllocatorStats {
+    bool available = false;         ///< 是否处于 kTracking 模式
+    int64_t in_use_bytes = 0;       ///< 当前已分配未释放的字节数
+    int64_t peak_bytes = 0;         ///< 历史峰值字节数
+    int64_t total_allocated_bytes = 0; ///< 累计分配字节数
+    int64_t num_allocs = 0;         ///< 累计分配次数
+};
+
+/**
+ * @brief 推理取消令牌，与具体推理后端无关
+ *
+ * 调用方 (如截止时间取消线程) 调用 Cancel()；引擎在 Run 期间通过 SetHook() 登记
+ * 把取消转交给后端的回调 (InferenceEngine 中为 Ort::RunOptions::SetTerminate())，
+ * 也可以在自身的循环中轮询 IsCancelled()。复用前由调用方 Reset()。
+ */
+class CancelToken {
+public:
+    /// 请求取消；已登记回调时立即调用 (线程安全)
+    void Cancel() {
+        cancelled_.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (hook_) hook_();
+    }
+
+    /// 清除取消标记，供下一次推理复用
+    void Reset() { cancelled_.store(false, std::memory_order_release); }
+
+    bool IsCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    /// 登记取消回调；若此前已被取消则立即调用一次
+    void SetHook(std::function<void()> hook) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hook_ = std::move(hook);
+        if (hook_ && IsCancelled()) hook_();
+    }
+
+    /// 注销取消回调，返回后回调不会再被调用
+    void ClearHook() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hook_ = nullptr;
+    }
+
+private:
+    std::atomic<bool> cancelled_{false};
+    std::mutex mutex_;
+    std::function<void()> hook_;
+};
+
+/**
+ * @brief 推理引擎接口
+ *
+ * BenchmarkRunner 与 InferenceServer 只依赖该接口，可替换为 ONNX Runtime 以外的实现
+ * (如用于测量压测框架自身开销的 NullEngine)。Run 需支持多线程并发调用。
+ */
+class Engine {
+public:
+    virtual ~Engine() = default;
+
+    /**
+     * @brief 执行推理。
+     *
+     * @param input_data 输入数据（展平的 float 数组）。
+     * @return std::vector<float> 推理结果（展平的 float 数组）。
+     */
+    virtual std::vector<float> Run(const std::vector<float>& input_data) = 0;
+
+    /**
+     * @brief 执行推理 (可取消)。
+     *
+     * 其他线程可在推理过程中调用 cancel.Cancel() 使本次推理尽快中止，此时抛出异常；
+     * 调用前 cancel 已被取消时同样抛出。不支持取消的实现可忽略 cancel。
+     *
+     * @param input_data 输入数据（展平的 float 数组）。
+     * @param cancel 本次推理的取消令牌。
+     * @return std::vector<float> 推理结果（展平的 float 数组）。
+     */
+    virtual std::vector<float> Run(const std::vector<float>& input_data, CancelToken& cancel) = 0;
+
+    /**
+     * @brief 获取输入 Tensor 元素总数。
+     */
+    virtual int64_t GetInputSize() const = 0;
+
+    /**
+     * @brief 获取加载模型时堆内存的增量 (字节)，不适用时返回 0。
+     */
+    virtual int64_t GetSessionMemoryBytes() const { return 0; }
+
+    /**
+     * @brief 获取计数分配器的统计数据，不适用时 available 为 false。
+     */
+    virtual AllocatorStats GetAllocatorStats() const { return AllocatorStats(); }
+};
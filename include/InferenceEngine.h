@@ -1,28 +1,54 @@
 #pragma once
 
+#include "Engine.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <onnxruntime_cxx_api.h>
 
+/**
+ * @brief CPU 内存分配器模式
+ */
+enum class AllocatorMode {
+    kSession,     ///< 每个 Session 独立的 CPU arena (ONNX Runtime 默认行为)
+    kSharedArena, ///< 进程级共享 arena (Env::CreateAndRegisterAllocator)，多个 Session 共用
+    kTracking     ///< 进程级共享的计数分配器 (无 arena)，可精确统计峰值与每次推理的分配量
+};
+
+/**
+ * @brief 推理引擎的内存相关配置
+ */
+struct MemoryOptions {
+    AllocatorMode allocator = AllocatorMode::kSession; ///< 分配器模式
+    bool enable_mem_pattern = true;    ///< SessionOptions::EnableMemPattern (按首次推理规划激活内存)
+    bool enable_cpu_mem_arena = true;  ///< SessionOptions::EnableCpuMemArena (仅 kSession 模式生效)
+
+    // 以下仅 kSharedArena 模式生效，-1 / 0 表示使用 ONNX Runtime 默认值
+    int arena_extend_strategy = -1;    ///< 0 = kNextPowerOfTwo, 1 = kSameAsRequested
+    int arena_initial_chunk_bytes = -1; ///< arena 首个内存块大小 (字节)
+    size_t arena_max_mem_bytes = 0;    ///< arena 上限 (字节)，0 表示不限制
+};
+
 /**
  * @brief 推理引擎类，封装 ONNX Runtime 的核心功能。
  * 
  * 负责模型的加载、Tensor 内存管理以及执行推理。
  */
-class InferenceEngine {
+class InferenceEngine : public Engine {
 public:
     InferenceEngine();
-    ~InferenceEngine();
+    ~InferenceEngine() override;
 
     /**
      * @brief 加载 ONNX 模型。
      * 
      * @param model_path 模型文件的路径 (.onnx)。
      * @param opt_level 优化级别 (0=Disable, 1=Basic, 99=All). Default: 99.
-     * @throws std::runtime_error 如果加载失败。
+     * @param memory 内存分配相关配置。
+     * @throws std::runtime_error 如果加载失败，或进程内已有其他引擎以不同配置注册了共享分配器。
      */
-    void LoadModel(const std::string& model_path, int opt_level = 99);
+    void LoadModel(const std::string& model_path, int opt_level = 99,
+                   const MemoryOptions& memory = MemoryOptions());
 
     /**
      * @brief 执行推理。
@@ -30,7 +56,19 @@ public:
      * @param input_data 输入数据（展平的 float 数组）。
      * @return std::vector<float> 推理结果（展平的 float 数组）。
      */
-    std::vector<float> Run(const std::vector<float>& input_data);
+    std::vector<float> Run(const std::vector<float>& input_data) override;
+
+    /**
+     * @brief 执行推理 (可取消)。
+     *
+     * 每次推理使用独立的 Ort::RunOptions，并在推理期间向 cancel 登记 SetTerminate() 回调：
+     * 其他线程调用 cancel.Cancel() 后本次推理尽快中止，抛出 Ort::Exception。
+     *
+     * @param input_data 输入数据（展平的 float 数组）。
+     * @param cancel 本次推理的取消令牌。
+     * @return std::vector<float> 推理结果（展平的 float 数组）。
+     */
+    std::vector<float> Run(const std::vector<float>& input_data, CancelToken& cancel) override;
 
     /**
      * @brief 获取模型需要的输入 Tensor 元素总数。
@@ -39,9 +77,27 @@ public:
      * 
      * @return int64_t 元素个数 (如 1x3x224x224 = 150528)。
      */
-    int64_t GetInputSize() const;
+    int64_t GetInputSize() const override;
+
+    /**
+     * @brief 获取加载模型 (创建 Session) 时堆内存的增量。
+     *
+     * 包含权重、图优化后的 Session 状态等；基于 glibc 堆统计，加载期间应避免其他线程大量分配。
+     *
+     * @return int64_t 字节数
+     */
+    int64_t GetSessionMemoryBytes() const override { return session_memory_bytes_; }
+
+    /**
+     * @brief 获取计数分配器的统计数据。
+     *
+     * @return AllocatorStats 非 kTracking 模式下 available 为 false
+     */
+    AllocatorStats GetAllocatorStats() const override;
 
 private:
+    std::vector<float> RunWithOptions(const std::vector<float>& input_data, const Ort::RunOptions& run_options);
+
     // ONNX Runtime 环境，整个进程通常只需要一个
     Ort::Env env_;
     // 会话对象，非线程安全（但在 Run 时只读模型是安全的，如果包含状态则需注意）
@@ -53,4 +109,10 @@ private:
     std::vector<const char*> output_node_names_;
     std::vector<int64_t> input_node_dims_;
     size_t input_tensor_size_ = 0;
+
+    // 输入 Tensor 的内存描述，加载时创建一次，避免每次 Run 重复构造
+    Ort::MemoryInfo memory_info_{nullptr};
+    AllocatorMode allocator_mode_ = AllocatorMode::kSession;
+    bool uses_env_allocator_ = false; // 是否登记为 Env 共享分配器的使用者
+    int64_t session_memory_bytes_ = 0;
 };
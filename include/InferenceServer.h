@@ -0,0 +1,181 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+#include "Engine.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 帧协议 (长度前缀的二进制格式，本机字节序)
+ *
+ * 请求：ServingRequestHeader + payload_bytes 字节的 float 输入
+ * 响应：ServingResponseHeader + payload_bytes 字节的 float 输出
+ */
+constexpr uint32_t kServingRequestMagic = 0x51524249;  // "IBRQ"
+constexpr uint32_t kServingResponseMagic = 0x53524249; // "IBRS"
+constexpr uint32_t kServingMaxPayloadBytes = 256u * 1024 * 1024;
+constexpr int kServingSendTimeoutMs = 5000; ///< 默认写超时：客户端持续不读取响应时断开连接
+
+struct ServingRequestHeader {
+    uint32_t magic;          ///< kServingRequestMagic
+    uint32_t payload_bytes;  ///< 输入数据字节数
+    uint64_t request_id;     ///< 客户端请求编号，原样返回
+};
+
+struct ServingResponseHeader {
+    uint32_t magic;          ///< kServingResponseMagic
+    uint32_t payload_bytes;  ///< 输出数据字节数
+    uint64_t request_id;     ///< 对应的请求编号
+    uint64_t queue_ns;       ///< 服务端排队时长 (收齐请求帧 -> Worker 取出)
+    uint64_t infer_ns;       ///< 推理时长
+    uint64_t server_ns;      ///< 服务端总驻留时长 (收齐请求帧 -> 开始发送响应)
+    uint32_t status;         ///< 0 成功，非 0 表示推理失败 (此时无 payload)
+    uint32_t reserved;
+};
+
+/**
+ * @brief 端到端压测结果 (客户端视角)
+ */
+struct ServingResult {
+    double qps = 0.0;             ///< 端到端吞吐量
+    int completed_requests = 0;   ///< 成功完成的请求数
+    int failed_requests = 0;      ///< 服务端返回失败或连接异常的请求数
+    double e2e_avg_ms = 0.0;      ///< 端到端平均延迟
+    double e2e_p99_ms = 0.0;      ///< 端到端 P99 延迟
+    double network_avg_ms = 0.0;  ///< 网络与序列化开销 (端到端 - 服务端驻留)
+    double queue_avg_ms = 0.0;    ///< 服务端排队
+    double queue_p99_ms = 0.0;    ///< 服务端排队 P99
+    double infer_avg_ms = 0.0;    ///< 推理
+    double infer_p99_ms = 0.0;    ///< 推理 P99
+};
+
+/**
+ * @brief 内嵌的本地推理服务 (epoll)
+ *
+ * 一个 IO 线程通过 epoll 负责 accept 与读取请求帧，解析出的请求进入队列，
+ * 由 N 个 Worker 线程调用推理引擎 (Engine) 并直接写回响应。
+ * 客户端不读取响应导致写出停滞超过 send_timeout_ms 时，服务端关闭该连接，不会一直占住 Worker。
+ * 用作服务层的本地替身，度量序列化、socket 与调度带来的额外开销。
+ *
+ * 端点格式：
+ * - "tcp:<host>:<port>"，如 "tcp:127.0.0.1:0" (端口 0 表示自动分配)
+ * - "unix:<path>"，如 "unix:/tmp/inferbench.sock"
+ */
+class InferenceServer {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param engine 推理引擎 (引用，生命周期需长于 Server)
+     * @param send_timeout_ms 写响应时允许的最长停滞 (毫秒，期间没有任何字节写出)
+     */
+    explicit InferenceServer(Engine& engine, int send_timeout_ms = kServingSendTimeoutMs);
+    ~InferenceServer();
+
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+
+    /**
+     * @brief 绑定端点并启动 IO 线程与 Worker 线程
+     *
+     * @param endpoint 监听端点
+     * @param workers Worker 线程数
+     * @throws std::runtime_error 如果端点格式错误或绑定失败
+     */
+    void Start(const std::string& endpoint, int workers);
+
+    /**
+     * @brief 停止服务并关闭所有连接 (可重复调用)
+     */
+    void Stop();
+
+    /**
+     * @brief 实际监听的端点 (tcp 端口 0 时返回分配后的端口)
+     */
+    const std::string& GetEndpoint() const { return endpoint_; }
+
+private:
+    // 单个客户端连接。Worker 持有 shared_ptr，连接关闭时 fd 在最后一个引用释放后才 close
+    struct Connection {
+        explicit Connection(int fd) : fd(fd) {}
+        ~Connection();
+        int fd;
+        std::vector<char> read_buffer;
+        std::mutex write_mutex; // 同一连接上的响应串行写出
+        bool broken = false;    // 写出失败或超时后置位，后续响应直接丢弃 (受 write_mutex 保护)
+    };
+
+    // 已收齐的请求
+    struct Job {
+        std::shared_ptr<Connection> conn;
+        uint64_t request_id;
+        std::vector<float> input;
+        std::chrono::steady_clock::time_point received;
+    };
+
+    void IoLoop();
+    void WorkerLoop();
+    void Accept();
+    /// 读取并解析请求帧；返回 false 表示连接应关闭
+    bool ReadFrames(const std::shared_ptr<Connection>& conn);
+    void CloseConnection(int fd);
+
+    Engine& engine_;
+    int send_timeout_ms_;
+    std::string endpoint_;
+    std::string unix_path_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+
+    std::map<int, std::shared_ptr<Connection>> connections_; // 仅 IO 线程访问
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<Job> queue_;
+    std::atomic<bool> stopping_{false}; // 修改时持有 queue_mutex_；写响应的 Worker 无锁读取
+
+    std::thread io_thread_;
+    std::vector<std::thread> workers_;
+};
+
+/**
+ * @brief 内置客户端压测器
+ *
+ * 每个连接一个线程，闭环地发送请求并等待响应 (与 BenchmarkRunner 相同的“抢单模式”)，
+ * 结合服务端在响应头中回报的排队/推理耗时，把端到端延迟拆分为网络、排队与推理三部分。
+ */
+class LoadClient {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param endpoint 服务端端点 (格式同 InferenceServer)
+     */
+    explicit LoadClient(const std::string& endpoint);
+
+    /**
+     * @brief 执行端到端压测
+     *
+     * @param config 压测配置：threads 为连接数，requests 为总请求数，warmup_rounds 为预热请求数
+     * @param input_size 每个请求的输入元素个数
+     * @return ServingResult 统计结果
+     * @throws std::runtime_error 如果无法连接服务端
+     */
+    ServingResult Run(const BenchmarkConfig& config, int64_t input_size);
+
+private:
+    /// 建立一个阻塞连接
+    int Connect() const;
+
+    std::string endpoint_;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief 定长对数-线性延迟直方图 (纳秒)
+ *
+ * 与 HdrHistogram 思路相同：每个 2 的幂区间再线性划分为 64 个子桶，
+ * 相对误差不超过 1/64 (约 1.6%)，覆盖 0 ~ 约 39 小时。
+ * 结构体是平凡可拷贝的 POD，不含指针，可以直接放进跨进程共享内存，
+ * 由各 Worker 各自写入、最后由协调者合并。
+ */
+struct LatencyHistogram {
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 47; // 2^47 ns ~= 39 小时
+    static constexpr int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBucketCount;
+
+    uint64_t counts[kBucketCount];
+    uint64_t total_count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+
+    /**
+     * @brief 清零
+     */
+    void Reset();
+
+    /**
+     * @brief 记录一个样本
+     */
+    void Record(uint64_t value_ns) {
+        counts[BucketIndex(value_ns)]++;
+        total_count++;
+        sum_ns += value_ns;
+        if (value_ns < min_ns) min_ns = value_ns;
+        if (value_ns > max_ns) max_ns = value_ns;
+    }
+
+    /**
+     * @brief 合并另一个直方图
+     */
+    void Merge(const LatencyHistogram& other);
+
+    /**
+     * @brief 计算百分位数
+     *
+     * @param percentile 百分位 (e.g. 0.99)
+     * @return double 对应的延迟 (毫秒)，取所在桶的中点
+     */
+    double PercentileMs(double percentile) const;
+
+    /**
+     * @brief 平均延迟 (毫秒)
+     */
+    double MeanMs() const {
+        return total_count > 0 ? static_cast<double>(sum_ns) / total_count / 1e6 : 0.0;
+    }
+
+    /**
+     * @brief 样本值对应的桶编号
+     */
+    static int BucketIndex(uint64_t value_ns);
+
+    /**
+     * @brief 桶的下界 (纳秒)
+     */
+    static uint64_t BucketLowerBound(int index);
+};
+
+static_assert(std::is_trivially_copyable<LatencyHistogram>::value,
+              "LatencyHistogram must stay trivially copyable for shared memory");
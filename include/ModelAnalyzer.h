@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 单个算子类型的开销汇总
+ */
+struct OpCost {
+    std::string op_type;   ///< 算子类型 (非默认 domain 时带前缀，如 "com.microsoft.Attention")
+    int count = 0;         ///< 节点个数
+    double flops = 0.0;    ///< 浮点运算次数 (一次乘加计为 2)
+    double bytes = 0.0;    ///< 读写字节数 (输入 + 输出)
+};
+
+/**
+ * @brief 整个模型单次推理的静态开销估计
+ */
+struct ModelCost {
+    int node_count = 0;              ///< 图中节点数 (不含子图)
+    int unanalyzed_nodes = 0;        ///< 形状未知或算子不支持、未计入 FLOPs 的节点数
+    int64_t parameter_count = 0;     ///< 参数个数 (所有 initializer 的元素数)
+    int64_t parameter_bytes = 0;     ///< 参数字节数
+    int64_t activation_bytes = 0;    ///< 所有中间张量 (含图输入) 的字节数之和
+    int64_t peak_activation_bytes = 0; ///< 按节点顺序执行时同时存活的中间张量峰值
+    double flops = 0.0;              ///< 总 FLOPs
+    double bytes = 0.0;              ///< 总访存字节数 (逐节点输入 + 输出之和，不考虑融合与缓存复用)
+    std::vector<OpCost> ops;         ///< 按算子类型汇总，按 FLOPs 降序
+
+    /**
+     * @brief 算术强度 (FLOPs / Byte)
+     */
+    double ArithmeticIntensity() const { return bytes > 0 ? flops / bytes : 0.0; }
+};
+
+/**
+ * @brief ONNX 模型静态开销分析器
+ *
+ * 内置一个只解析所需字段的轻量 protobuf 读取器，不依赖 onnx / protobuf 库。
+ * 形状优先取自模型中的 value_info (经 onnx.shape_inference 处理过的模型覆盖最全)，
+ * 缺失时对常见算子做简单的形状推导；动态维度一律按 1 计算 (与 InferenceEngine 一致)。
+ *
+ * 支持估算 FLOPs 的算子：Conv、ConvTranspose、Gemm、MatMul、池化、归一化、Softmax、
+ * 逐元素运算，以及 com.microsoft 的 Attention / MultiHeadAttention 融合算子。
+ * 纯数据搬运的算子 (Reshape、Transpose、Concat 等) 只计访存字节。
+ */
+class ModelAnalyzer {
+public:
+    /**
+     * @brief 分析模型文件
+     *
+     * @param model_path ONNX 模型路径
+     * @return ModelCost 开销估计
+     * @throws std::runtime_error 如果文件无法读取或不是合法的 ONNX 模型
+     */
+    static ModelCost Analyze(const std::string& model_path);
+
+    /**
+     * @brief 分析内存中的序列化 ModelProto
+     *
+     * @param data 序列化后的 ModelProto
+     * @return ModelCost 开销估计
+     * @throws std::runtime_error 如果数据不是合法的 ONNX 模型
+     */
+    static ModelCost AnalyzeBuffer(const std::string& data);
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Engine.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 空推理引擎：不加载模型，每次 Run 仅忙等固定时长后返回
+ *
+ * 用于标定压测框架自身的开销：spin_ns = 0 时 BenchmarkRunner 测得的延迟与
+ * 单请求耗时完全来自计时、记录与派发逻辑；spin_ns > 0 可模拟固定耗时的小模型。
+ * 输出分配与真实引擎一致 (每次返回新 vector)。忙等期间可通过 CancelToken 取消。
+ */
+class NullEngine : public Engine {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param input_size 声明的输入元素个数 (决定 Runner 生成的输入大小)
+     * @param spin_ns 每次 Run 忙等的纳秒数，0 表示立即返回
+     * @param output_size 返回的输出元素个数
+     */
+    explicit NullEngine(int64_t input_size, int64_t spin_ns = 0, int64_t output_size = 1);
+
+    std::vector<float> Run(const std::vector<float>& input_data) override;
+    std::vector<float> Run(const std::vector<float>& input_data, CancelToken& cancel) override;
+    int64_t GetInputSize() const override { return input_size_; }
+
+private:
+    std::vector<float> Spin(const std::vector<float>& input_data, const CancelToken* cancel);
+
+    int64_t input_size_;
+    int64_t spin_ns_;
+    int64_t output_size_;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 能耗与 CPU 频率采样快照
+ */
+struct PowerSample {
+    double energy_joules = 0.0;   ///< 自构造起累计的 RAPL package 能耗 (所有 socket 之和，已处理计数器回绕)
+    double avg_freq_mhz = 0.0;    ///< 繁忙核的平均当前频率 (见 PowerMonitor 的说明)
+    double min_freq_mhz = 0.0;    ///< 繁忙核中的最低频率
+    int64_t throttle_count = 0;   ///< thermal_throttle 计数之和 (core + package)
+};
+
+/**
+ * @brief 一段时间 (Begin() 到 End()) 内的能耗与频率汇总
+ */
+struct PowerSummary {
+    double energy_joules = 0.0;  ///< 能耗增量
+    double duration_sec = 0.0;   ///< 统计窗口时长，平均功率 = energy_joules / duration_sec
+    double avg_freq_mhz = 0.0;   ///< 各次采样平均频率的均值
+    double min_freq_mhz = 0.0;   ///< 采样到的最低单核频率
+    int64_t throttle_events = 0; ///< thermal_throttle 计数增量
+    int below_base_events = 0;   ///< 最低单核频率跌破基础频率的次数 (按采样边沿计)
+};
+
+/**
+ * @brief 能耗与频率监控器
+ *
+ * - 能耗：读取 powercap 下顶层 RAPL 域 (intel-rapl:N，即各 CPU package) 的 energy_uj，
+ *   按 max_energy_range_uj 处理回绕后累加。只统计 package 域：core / uncore 子域已包含其中，dram 子域不计入。
+ * - 频率：读取 cpu<N>/cpufreq/scaling_cur_freq。只统计本进程可运行的 CPU (sched_getaffinity)，
+ *   且只统计两次采样之间繁忙 (/proc/stat 中非空闲时间占比 >= 50%) 的核：空闲核在 powersave 下
+ *   长期低于基础频率，计入会拉低平均频率并被误报为降频。没有繁忙核的采样不计入频率统计；
+ *   /proc/stat 不可读或尚无上一次读数时退回统计全部可运行的 CPU。
+ * - 节流：读取 cpu<N>/thermal_throttle/core_throttle_count (仅可运行的 CPU) 与 package_throttle_count
+ *   (每个 package 计一次)。
+ *
+ * 虚拟机中通常没有这些接口，内核 5.10 之后 energy_uj 默认仅 root 可读，
+ * 此时对应的 Has* 返回 false，Sample() 中相应字段保持 0。
+ * 注意 RAPL 统计的是整个 package 的能耗，包含压测进程以外的负载。
+ */
+class PowerMonitor {
+public:
+    /**
+     * @brief 构造函数，扫描可用的接口
+     *
+     * @param powercap_dir powercap 根目录 (测试时可指向伪造的目录)
+     * @param cpu_dir CPU sysfs 根目录
+     * @param proc_stat 每核 CPU 时间统计文件，用于判断繁忙的核
+     * @param cpus 只统计这些 CPU 编号，为空表示取本进程的 sched_getaffinity 集合
+     */
+    explicit PowerMonitor(const std::string& powercap_dir = "/sys/class/powercap",
+                          const std::string& cpu_dir = "/sys/devices/system/cpu",
+                          const std::string& proc_stat = "/proc/stat",
+                          const std::vector<int>& cpus = {});
+
+    /// 是否有可读的 RAPL 能耗计数器
+    bool HasEnergy() const { return !domains_.empty(); }
+
+    /// 是否有可读的 cpufreq 频率
+    bool HasFrequency() const { return !freq_paths_.empty(); }
+
+    /// 是否有 thermal_throttle 计数器
+    bool HasThrottleCounters() const { return !core_throttle_paths_.empty() || !package_throttle_paths_.empty(); }
+
+    /**
+     * @brief 基础 (非睿频) 频率
+     *
+     * 取自 cpufreq/base_frequency (intel_pstate)，低于它说明处于功耗或温度限制之下。
+     *
+     * @return double MHz，不可用时返回 0
+     */
+    double GetBaseFrequencyMhz() const { return base_freq_mhz_; }
+
+    /**
+     * @brief 开始一段统计：记录能耗与节流计数基线，清空频率统计
+     */
+    void Begin();
+
+    /**
+     * @brief 采样一次并计入频率统计 (线程安全)；End() 之后的采样不再计入
+     */
+    PowerSample Sample();
+
+    /**
+     * @brief 结束统计：记录能耗与节流计数终值
+     *
+     * 应与 Begin() 一起紧贴被测区间 (如 Worker 启动前与 join 之后) 调用，
+     * 否则窗口内会混入监控线程启停等区间外的能耗。
+     */
+    void End();
+
+    /**
+     * @brief 返回 Begin() 到 End() 的汇总；未调用 End() 时以当前时刻为终点
+     */
+    PowerSummary Summarize();
+
+private:
+    PowerSample SampleLocked();
+    /// 读取 /proc/stat，返回自上次读取以来繁忙的 CPU；无法判断时返回 false
+    bool ReadBusyCpus(std::set<int>& busy);
+
+    struct EnergyDomain {
+        std::string energy_path;
+        int64_t max_range_uj = 0;
+        int64_t last_uj = 0;
+        double accumulated_joules = 0.0;
+    };
+
+    std::vector<EnergyDomain> domains_;
+    std::vector<std::string> freq_paths_;
+    std::vector<int> freq_cpus_;        // 与 freq_paths_ 一一对应的 CPU 编号
+    std::string proc_stat_path_;
+    std::map<int, std::pair<uint64_t, uint64_t>> last_cpu_times_; // CPU -> (非空闲, 总计) jiffies
+    std::vector<std::string> core_throttle_paths_;
+    std::map<int, std::string> package_throttle_paths_; // physical_package_id -> 路径
+    double base_freq_mhz_ = 0.0;
+
+    // Begin() 以来的统计
+    PowerSample baseline_;
+    PowerSample end_;
+    bool ended_ = false;
+    std::chrono::steady_clock::time_point begin_time_;
+    std::chrono::steady_clock::time_point end_time_;
+    double freq_sum_mhz_ = 0.0;
+    int freq_samples_ = 0;
+    double min_freq_mhz_ = 0.0;
+    int below_base_events_ = 0;
+    bool below_base_ = false;
+
+    std::mutex mutex_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+#include "InferenceEngine.h"
+#include "SystemMonitor.h"
+#include <string>
+
+/**
+ * @brief 多进程压测调度器
+ *
+ * 与 BenchmarkRunner 的“单进程多线程、共享一个 Session”不同，
+ * 协调者 fork 出 N 个单线程 Worker 进程，每个进程独立加载模型
+ * (独立的 Ort::Env / Session / 堆)，模拟“多个单线程服务进程”的部署形态。
+ *
+ * 进程间通过一段匿名共享内存协作：
+ * - 启动屏障：所有 Worker 加载并预热完毕后才同时开始计时；
+ * - 抢单计数：共享的原子剩余请求数，与线程模式的负载均衡方式一致；
+ * - 结果汇总：每个 Worker 写入自己槽位的 LatencyHistogram 与计数器，
+ *   全部退出后由协调者合并为一份 BenchmarkResult。
+ *
+ * 注意：协调者进程自身不创建 ONNX Runtime 对象，避免 fork 时继承其内部线程状态。
+ */
+class ProcessRunner {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param model_path 模型路径 (由每个 Worker 进程各自加载)
+     * @param opt_level 图优化级别，含义同 InferenceEngine::LoadModel
+     * @param monitor 系统监控器 (用于采样 CPU 与汇总各 Worker 的 RSS)
+     * @param memory 每个 Worker 加载模型时使用的内存配置
+     */
+    ProcessRunner(const std::string& model_path, int opt_level, SystemMonitor& monitor,
+                  const MemoryOptions& memory = MemoryOptions());
+    ~ProcessRunner() = default;
+
+    /**
+     * @brief 执行多进程压测
+     *
+     * 此函数是阻塞的，直到所有 Worker 进程退出。
+     *
+     * @param config 压测配置，Worker 进程数取 config.processes
+     * @return BenchmarkResult 合并后的统计结果 (内存为各进程 RSS 之和)
+     * @throws std::runtime_error 如果共享内存创建、fork 或 Worker 加载模型失败
+     */
+    BenchmarkResult Run(const BenchmarkConfig& config);
+
+private:
+    std::string model_path_;
+    int opt_level_;
+    SystemMonitor& monitor_;
+    MemoryOptions memory_;
+};
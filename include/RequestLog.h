@@ -0,0 +1,186 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 请求完成状态 (写入日志的 status 字段)
+ */
+enum RequestStatus : uint16_t {
+    kRequestOk = 0,       ///< 正常完成
+    kRequestError = 1,    ///< 推理抛出异常
+    kRequestRejected = 2, ///< 准入控制拒绝 (预计无法在截止时间前完成，未执行推理)
+    kRequestTimeout = 3,  ///< 超过截止时间 (推理中被取消，或完成时已超时)
+};
+
+/**
+ * @brief 二进制请求日志中的单条记录 (定长 24 字节，小端)
+ */
+struct RequestLogRecord {
+    uint64_t timestamp_ns;  ///< 请求开始时间，相对日志起始时间 (RequestLogHeader::start_unix_ns)
+    uint64_t latency_ns;    ///< 推理延迟
+    uint32_t worker;        ///< Worker 编号 (线程或进程)
+    uint16_t shape_bucket;  ///< 输入形状分桶编号 (单一形状时恒为 0)
+    uint16_t status;        ///< RequestStatus
+};
+static_assert(sizeof(RequestLogRecord) == 24, "RequestLogRecord must stay 24 bytes");
+
+/**
+ * @brief 二进制请求日志文件头 (64 字节)
+ */
+struct RequestLogHeader {
+    char magic[8];           ///< "IBREQLOG"
+    uint32_t version;        ///< 格式版本，当前为 1
+    uint32_t record_size;    ///< 单条记录字节数
+    uint64_t start_unix_ns;  ///< 日志起始时间 (Unix 纪元纳秒)
+    uint64_t record_count;   ///< 已落盘的记录数 (每批写入后更新，异常退出时仍可信)
+    uint8_t reserved[32];
+};
+static_assert(sizeof(RequestLogHeader) == 64, "RequestLogHeader must stay 64 bytes");
+
+/**
+ * @brief 流式二进制请求日志写入器
+ *
+ * 面向数小时的长稳压测：每个 Worker 把记录追加到自己的定长缓冲区，
+ * 热路径只有一次结构体写入和一次自增；缓冲区写满后整块交给后台线程，
+ * 由后台线程拷贝进以内存映射方式按块扩展的只追加文件。
+ */
+class RequestLogWriter {
+public:
+    /**
+     * @brief 创建日志文件并启动后台刷盘线程
+     *
+     * @param path 日志文件路径 (已存在则覆盖)
+     * @param num_workers Worker 数量
+     * @param start_unix_ns 记录时间戳的起点 (Unix 纪元纳秒)
+     * @param buffer_records 每个缓冲区的记录条数
+     * @throws std::runtime_error 如果文件创建或映射失败
+     */
+    RequestLogWriter(const std::string& path, int num_workers, uint64_t start_unix_ns,
+                     size_t buffer_records = 4096);
+    ~RequestLogWriter();
+
+    RequestLogWriter(const RequestLogWriter&) = delete;
+    RequestLogWriter& operator=(const RequestLogWriter&) = delete;
+
+    /**
+     * @brief 追加一条记录 (仅允许 worker 对应的线程调用)
+     */
+    void Append(int worker, const RequestLogRecord& record) {
+        Buffer* buffer = active_[worker];
+        buffer->records[buffer->size++] = record;
+        if (buffer->size == buffer_records_) {
+            Submit(worker);
+        }
+    }
+
+    /**
+     * @brief 刷出所有缓冲区并关闭文件 (调用前所有 Worker 必须已停止追加)
+     */
+    void Close();
+
+    /**
+     * @brief 已落盘的记录数
+     */
+    uint64_t GetRecordCount() const;
+
+private:
+    struct Buffer {
+        std::unique_ptr<RequestLogRecord[]> records;
+        size_t size = 0;
+    };
+
+    /// 将 worker 的满缓冲区交给后台线程，并换一个空缓冲区
+    void Submit(int worker);
+    /// 后台刷盘线程主循环
+    void FlushLoop();
+    /// 将一批记录写入映射区 (仅后台线程调用)
+    void WriteRecords(const RequestLogRecord* records, size_t count);
+    /// 扩展文件与映射，使其至少容纳 required_bytes
+    void EnsureCapacity(size_t required_bytes);
+
+    size_t buffer_records_;
+    std::vector<std::unique_ptr<Buffer>> buffers_; // 所有缓冲区 (所有权)
+    std::vector<Buffer*> active_;                  // 每个 Worker 当前使用的缓冲区
+
+    mutable std::mutex mutex_;
+    std::condition_variable flush_cv_;  // 通知后台线程有满缓冲区
+    std::condition_variable free_cv_;   // 通知 Worker 有空缓冲区
+    std::deque<Buffer*> full_;
+    std::vector<Buffer*> free_;
+    bool closing_ = false;
+    std::thread flusher_;
+
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;   // 文件映射起始地址
+    size_t map_size_ = 0;      // 当前映射 (文件) 大小
+    uint64_t record_count_ = 0;
+};
+
+/**
+ * @brief 二进制请求日志读取器 (只读内存映射)
+ */
+class RequestLogReader {
+public:
+    RequestLogReader() = default;
+    ~RequestLogReader();
+
+    RequestLogReader(const RequestLogReader&) = delete;
+    RequestLogReader& operator=(const RequestLogReader&) = delete;
+
+    /**
+     * @brief 打开并校验日志文件
+     *
+     * @param path 日志文件路径
+     * @throws std::runtime_error 如果文件不存在或格式不正确
+     */
+    void Open(const std::string& path);
+
+    /**
+     * @brief 文件头
+     */
+    const RequestLogHeader& GetHeader() const { return *header_; }
+
+    /**
+     * @brief 有效记录数
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief 访问第 i 条记录
+     */
+    const RequestLogRecord& operator[](size_t i) const { return records_[i]; }
+
+    /**
+     * @brief 导出为 CSV (带表头，每条记录一行)
+     *
+     * @return true 写入成功
+     */
+    bool ExportCsv(const std::string& path) const;
+
+    /**
+     * @brief 按列导出为原始小端数组文件，便于 numpy.fromfile / Arrow 直接加载
+     *
+     * 生成 <prefix>.timestamp_ns.u64、<prefix>.latency_ns.u64、<prefix>.worker.u32、
+     * <prefix>.shape_bucket.u16、<prefix>.status.u16 五个文件。
+     *
+     * @return true 全部写入成功
+     */
+    bool ExportColumns(const std::string& prefix) const;
+
+private:
+    void Unmap();
+
+    uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    const RequestLogHeader* header_ = nullptr;
+    const RequestLogRecord* records_ = nullptr;
+    size_t count_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ModelAnalyzer.h"
+#include <cstddef>
+
+/**
+ * @brief 实测的机器峰值
+ */
+struct MachinePeak {
+    int threads = 0;                 ///< 测量时使用的线程数
+    double peak_gflops = 0.0;        ///< FP32 峰值算力 (GFLOP/s)
+    double peak_bandwidth_gbs = 0.0; ///< 内存带宽 (GB/s，STREAM Triad 口径)
+};
+
+/**
+ * @brief Roofline 分析结果
+ */
+struct RooflineReport {
+    double achieved_gflops = 0.0;        ///< 实测吞吐对应的算力 (FLOPs/请求 × QPS)
+    double achieved_bandwidth_gbs = 0.0; ///< 实测吞吐对应的访存带宽 (Bytes/请求 × QPS)
+    double arithmetic_intensity = 0.0;   ///< 模型算术强度 (FLOPs / Byte)
+    double ridge_point = 0.0;            ///< 机器平衡点 (peak_gflops / peak_bandwidth)
+    double attainable_gflops = 0.0;      ///< Roofline 上限 min(peak, AI × bandwidth)
+    double efficiency = 0.0;             ///< achieved / attainable
+    bool memory_bound = false;           ///< 算术强度低于平衡点
+};
+
+/**
+ * @brief Roofline 模型：判断模型在当前机器上是算力受限还是带宽受限
+ */
+class Roofline {
+public:
+    /**
+     * @brief 测量机器峰值
+     *
+     * - 算力：每个线程运行多条独立 FMA 依赖链的向量化循环 (x86 上按 AVX-512 / AVX2 / 基线
+     *   多版本编译，运行时选择)，统计总 FLOPs / 墙钟时间；
+     * - 带宽：多线程 STREAM Triad (a[i] = b[i] + s * c[i])，每个数组 array_bytes 字节，
+     *   按 3 × 数组大小计字节 (不含写分配)，取多次的最好值。
+     *
+     * 结果是“可移植代码能达到的峰值”，ONNX Runtime 手写的 GEMM 内核可能略高于此值。
+     *
+     * @param threads 线程数 (与压测并发一致时可直接对比)
+     * @param array_bytes Triad 单个数组的字节数，应远大于末级缓存
+     * @return MachinePeak 实测峰值
+     */
+    static MachinePeak MeasureMachinePeak(int threads, size_t array_bytes = 64u * 1024 * 1024);
+
+    /**
+     * @brief 结合静态开销、机器峰值与实测吞吐生成 Roofline 报告
+     *
+     * @param cost 模型单次推理的静态开销
+     * @param peak 机器峰值
+     * @param qps 实测吞吐量
+     * @return RooflineReport 分析结果
+     */
+    static RooflineReport BuildReport(const ModelCost& cost, const MachinePeak& peak, double qps);
+};
@@ -20,6 +20,16 @@ public:
      */
     double GetMemoryUsage();
 
+    /**
+     * @brief 获取指定进程的物理内存占用 (RSS)
+     *
+     * 多进程模式下由协调者汇总各 Worker 进程的内存。
+     *
+     * @param pid 进程号
+     * @return 占用内存大小，单位：MB；进程不存在时返回 0
+     */
+    double GetProcessMemoryUsage(int pid);
+
     /**
      * @brief 获取系统的整体 CPU 使用率
      * 
@@ -40,6 +50,16 @@ public:
      */
     bool CheckMemoryLimit(double limit_mb);
 
+    /**
+     * @brief 获取当前进程 malloc 堆中已分配的字节数
+     *
+     * 基于 glibc mallinfo2 (包含 mmap 分配的大块)，与 RSS 不同，
+     * 它只统计仍被程序持有的内存，不含已释放但未归还系统的部分。
+     *
+     * @return int64_t 字节数；非 glibc 平台返回 0
+     */
+    static int64_t GetHeapInUseBytes();
+
 private:
     // 记录上一次读取的 CPU 时间片总和
     int64_t last_total_cpu_time_ = 0;
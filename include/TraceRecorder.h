@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 单个请求的分段耗时 (Span)
+ *
+ * 时间戳均为相对 trace 原点的纳秒数。四个阶段首尾相接：
+ * [start, start + queue) 排队 -> 派发 -> 推理 -> 后处理。
+ * 被准入控制拒绝的请求只有排队阶段 (infer_ns = 0)。
+ */
+struct RequestSpan {
+    int64_t request_id = 0;  ///< 请求序号
+    int64_t start_ns = 0;    ///< 请求到达时间 (开环模式为预定到达时刻，闭环模式即取单时刻)
+    int64_t queue_ns = 0;    ///< 排队等待时长 (到达到被 Worker 取出)
+    int64_t dispatch_ns = 0; ///< 派发时长 (取出到开始推理：准入检查、计数采集、登记在途请求)
+    int64_t infer_ns = 0;    ///< 推理时长 (engine.Run)
+    int64_t post_ns = 0;     ///< 后处理时长 (推理返回后 Worker 侧的延迟记录等收尾)
+    int32_t worker = 0;      ///< Worker 线程编号
+    int32_t cpu = -1;        ///< 开始推理时所在的 CPU 核 (sched_getcpu)
+    int32_t voluntary_ctx_switches = 0;   ///< 期间主动上下文切换次数
+    int32_t involuntary_ctx_switches = 0; ///< 期间被动上下文切换次数 (被抢占)
+    int32_t minor_faults = 0; ///< 期间次缺页次数
+    int32_t major_faults = 0; ///< 期间主缺页次数 (需磁盘 IO)
+    uint16_t status = 0;      ///< 请求状态 (取值同 RequestStatus)
+};
+
+/**
+ * @brief 线程级资源计数快照 (getrusage(RUSAGE_THREAD))
+ */
+struct ThreadUsage {
+    long voluntary_ctx_switches = 0;
+    long involuntary_ctx_switches = 0;
+    long minor_faults = 0;
+    long major_faults = 0;
+
+    /**
+     * @brief 采集调用线程当前的计数
+     */
+    static ThreadUsage Capture();
+};
+
+/**
+ * @brief 计数器采样点 (如 CPU 使用率、内存)，导出为 trace 中的 counter track
+ */
+struct CounterSample {
+    std::string name;      ///< 计数器名称
+    int64_t timestamp_ns;  ///< 相对 trace 原点的时间戳
+    double value;          ///< 采样值
+};
+
+/**
+ * @brief 请求级 Span 记录器
+ *
+ * 每个 Worker 拥有一个预分配的环形缓冲区，记录时只写入本线程的槽位，
+ * 无锁、无内存分配。缓冲区写满后覆盖最旧的记录 (保留最近 capacity 条)。
+ * 压测结束后可导出为 Chrome Trace JSON，直接在 Perfetto / chrome://tracing 中打开。
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param num_workers Worker 数量 (每个 Worker 一个环形缓冲区)
+     * @param capacity_per_worker 每个 Worker 保留的最大 Span 数
+     */
+    TraceRecorder(int num_workers, size_t capacity_per_worker);
+
+    /**
+     * @brief 记录一个 Span (仅允许 span.worker 对应的线程调用)
+     */
+    void Record(const RequestSpan& span) {
+        Ring& ring = rings_[span.worker];
+        ring.spans[ring.count % ring.spans.size()] = span;
+        ring.count++;
+    }
+
+    /**
+     * @brief 添加计数器采样 (线程安全，供监控线程调用)
+     */
+    void AddCounter(const std::string& name, int64_t timestamp_ns, double value);
+
+    /**
+     * @brief 因缓冲区写满而被覆盖的 Span 数
+     */
+    uint64_t GetDroppedCount() const;
+
+    /**
+     * @brief 导出为 Chrome Trace Event 格式 (JSON)
+     *
+     * 每个 Worker 对应一个线程轨道，请求展开为 request / queue / dispatch / inference / post
+     * 嵌套切片 (request 切片的 status 参数标明完成、异常、拒绝或超时)；计数器采样导出为 counter track。
+     *
+     * @param path 输出文件路径
+     * @return true 写入成功
+     */
+    bool ExportChromeTrace(const std::string& path) const;
+
+private:
+    // 单个 Worker 的环形缓冲区，按缓存行对齐避免伪共享
+    struct alignas(64) Ring {
+        std::vector<RequestSpan> spans;
+        uint64_t count = 0;
+    };
+
+    std::vector<Ring> rings_;
+    mutable std::mutex counter_mutex_;
+    std::vector<CounterSample> counters_;
+};
@@ -1,14 +1,22 @@
 #include "BenchmarkRunner.h"
+#include "NullEngine.h"
+#include "PowerMonitor.h"
+#include "RequestLog.h"
+#include "TraceRecorder.h"
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <random>
 #include <thread>
+#include <sched.h>
+#include <memory>
 #include <mutex>
 #include <numeric>
+#include <sstream>
 
-BenchmarkRunner::BenchmarkRunner(InferenceEngine& engine, SystemMonitor& monitor)
+BenchmarkRunner::BenchmarkRunner(Engine& engine, SystemMonitor& monitor)
     : engine_(engine), monitor_(monitor) {}
 
 BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
@@ -23,9 +31,23 @@ BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
 
     // 2. 预热 (Warmup)
     // 目的：让 CPU caches 热起来 & 触发 ONNX Runtime 内部可能的 JIT/Allocations
+    // 预热是单线程的，顺便记录 arena 增长到稳定状态时的堆高水位 (正式压测期间由监控线程继续采样)。
+    // 计数分配器可用时直接用它的峰值，不采样堆 (mallinfo2 需要锁住所有 malloc arena)
+    AllocatorStats alloc_before_warmup = engine_.GetAllocatorStats();
+    const bool sample_heap = !alloc_before_warmup.available;
+    int64_t heap_before_warmup = sample_heap ? SystemMonitor::GetHeapInUseBytes() : 0;
+    int64_t heap_peak_warmup = heap_before_warmup;
+    std::vector<int64_t> warmup_samples_ns;
     for (int i = 0; i < config.warmup_rounds; ++i) {
+        auto warmup_start = std::chrono::steady_clock::now();
         engine_.Run(input_data);
+        warmup_samples_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - warmup_start).count());
+        if (sample_heap) heap_peak_warmup = std::max(heap_peak_warmup, SystemMonitor::GetHeapInUseBytes());
     }
+    AllocatorStats alloc_before_run = engine_.GetAllocatorStats();
+    // 下面创建的 Trace 环形缓冲区、请求日志缓冲区、延迟数组等属于压测框架，单独记下其堆占用并从峰值中扣除
+    int64_t heap_before_harness = sample_heap ? SystemMonitor::GetHeapInUseBytes() : 0;
 
     // 3. 准备并发控制
     std::atomic<int> remaining_requests(config.requests);
@@ -34,56 +56,378 @@ BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
     
     // Per-thread statistics to avoid lock verify
     std::vector<std::vector<double>> all_thread_latencies(config.threads);
+    for (auto& local_lats : all_thread_latencies) {
+        local_lats.reserve(config.requests / std::max(config.threads, 1) + 1); // 均分时压测期间不再扩容
+    }
+
+    // 看门狗处置状态：编号 >= active_workers 的 Worker 暂停取单
+    std::atomic<int> active_workers(config.threads);
+    std::atomic<bool> aborted(false);
+    std::atomic<int> watchdog_triggers(0);
+    std::mutex action_mutex;
+    auto last_action_time = std::chrono::steady_clock::time_point{};
+
+    // RSS 看门狗与 cgroup 看门狗共用同一套处置逻辑
+    auto apply_watchdog_action = [&](const std::string& reason) {
+        std::lock_guard<std::mutex> lock(action_mutex);
+        // 冷却 1 秒，避免同一次压力事件被连续处置多次 (如并发被连续减半)
+        auto now = std::chrono::steady_clock::now();
+        if (watchdog_triggers > 0 && now - last_action_time < std::chrono::seconds(1)) {
+            return;
+        }
+        last_action_time = now;
+        watchdog_triggers++;
+
+        WatchdogAction action = config.watchdog_action;
+        if (action == WatchdogAction::kShrinkConcurrency && active_workers <= 1) {
+            action = WatchdogAction::kStopAdmission;
+        }
+
+        switch (action) {
+            case WatchdogAction::kShrinkConcurrency: {
+                int next = std::max(1, active_workers.load() / 2);
+                active_workers = next;
+                std::cerr << "\n[Watchdog] " << reason << " Shrinking concurrency to " << next << "." << std::endl;
+                break;
+            }
+            case WatchdogAction::kAbort:
+                aborted = true;
+                remaining_requests = 0;
+                std::cerr << "\n[Watchdog] " << reason << " Aborting..." << std::endl;
+                break;
+            case WatchdogAction::kStopAdmission:
+            default:
+                // Force stop all requests
+                remaining_requests = 0;
+                std::cerr << "\n[Watchdog] " << reason << " Stopping..." << std::endl;
+                break;
+        }
+    };
+
+    // Span 追踪 (可选)：时间戳统一相对 trace_origin (steady_clock，与下面的到达/取单时刻同一时间轴)
+    auto trace_origin = std::chrono::steady_clock::now();
+    auto since_origin_ns = [&](std::chrono::steady_clock::time_point tp) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(tp - trace_origin).count();
+    };
+    std::unique_ptr<TraceRecorder> tracer;
+    if (!config.trace_path.empty()) {
+        tracer = std::make_unique<TraceRecorder>(config.threads, config.trace_capacity);
+    }
+
+    // 二进制逐请求日志 (可选)：Worker 只写本线程缓冲区，由后台线程落盘
+    std::unique_ptr<RequestLogWriter> request_log;
+    if (!config.request_log_path.empty()) {
+        uint64_t start_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        request_log = std::make_unique<RequestLogWriter>(config.request_log_path, config.threads, start_unix_ns);
+    }
+
+    // 截止时间与准入控制 (可选)
+    // 时间戳统一为相对 run_origin 的 steady_clock 纳秒 (与 trace 原点相同，Span 可直接使用)
+    const bool deadline_enabled = config.deadline_ms > 0;
+    const int64_t deadline_budget_ns = static_cast<int64_t>(config.deadline_ms * 1e6);
+    auto run_origin = trace_origin;
+    auto now_ns = [&]() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - run_origin).count();
+    };
+
+    // 开环模式：预先生成泊松到达时刻 (相对压测开始)
+    std::vector<int64_t> arrival_offsets_ns;
+    if (config.arrival_rate > 0) {
+        arrival_offsets_ns.resize(std::max(config.requests, 0));
+        std::mt19937 arrival_gen(7);
+        std::exponential_distribution<double> interval(config.arrival_rate);
+        double t = 0.0;
+        for (auto& offset : arrival_offsets_ns) {
+            offset = static_cast<int64_t>(t * 1e9);
+            t += interval(arrival_gen);
+        }
+    }
+
+    // 推理耗时预估 (EWMA，alpha = 1/8)，初值取预热中位数 (首轮预热包含内存规划等一次性开销，均值会偏高)
+    int64_t initial_estimate_ns = 0;
+    if (!warmup_samples_ns.empty()) {
+        auto mid = warmup_samples_ns.begin() + warmup_samples_ns.size() / 2;
+        std::nth_element(warmup_samples_ns.begin(), mid, warmup_samples_ns.end());
+        initial_estimate_ns = *mid;
+    }
+    std::atomic<int64_t> service_estimate_ns(initial_estimate_ns);
+    // 预估只靠放行的请求更新，偏高时会一直拒绝下去：连续拒绝 kAdmissionProbeInterval 个后
+    // 放行一个探测请求 (仅当截止时间尚未过去)，用它的实际耗时校正预估
+    constexpr int kAdmissionProbeInterval = 16;
+    std::atomic<int> consecutive_rejections(0);
+
+    // 每个 Worker 正在执行的请求，由取消线程检查是否超过截止时间
+    struct InFlight {
+        std::mutex mutex;
+        CancelToken cancel;
+        int64_t deadline_ns = 0; // 0 表示空闲
+        bool cancelled = false;
+    };
+    std::vector<std::unique_ptr<InFlight>> in_flight;
+    if (deadline_enabled) {
+        for (int t = 0; t < config.threads; ++t) in_flight.push_back(std::make_unique<InFlight>());
+    }
+
+    int64_t harness_heap_bytes =
+        sample_heap ? std::max<int64_t>(SystemMonitor::GetHeapInUseBytes() - heap_before_harness, 0) : 0;
+    int64_t heap_peak_run = 0;
+
+    std::atomic<int> failed_requests(0);
+    std::atomic<int> rejected_requests(0);
+    std::atomic<int> timeout_requests(0);
+    std::atomic<int> goodput_requests(0);
+    std::atomic<int64_t> queue_ns_sum(0);
+    std::atomic<int> dispatched_requests(0);
 
     // 4. 启动系统监控线程
     std::atomic<bool> monitor_running(true);
     std::vector<double> cpu_samples;
     std::vector<double> mem_samples;
-    
+
+    // cgroup v2: 记录压测前的 CPU 节流与 OOM 计数，用于计算增量
+    CgroupWatchdog cgroup;
+    bool cgroup_available = cgroup.IsAvailable();
+    CgroupCpuStat cpu_stat_begin = cgroup.ReadCpuStat();
+    CgroupMemoryStat mem_stat_begin = cgroup.ReadMemoryStat();
+    int64_t cgroup_peak_bytes = mem_stat_begin.current_bytes;
+
+    // 能耗与频率：与 CPU/内存同周期采样 (RAPL / cpufreq 不可用时自动跳过)，
+    // 统计窗口在 Worker 启动与 join 处开闭，与 total_time_sec 对齐
+    PowerMonitor power;
+
     std::thread monitor_thread([&]() {
+        PowerSample last_power = power.Sample();
+        int monitor_ticks = 0;
+        auto last_power_time = std::chrono::steady_clock::now();
         while (monitor_running) {
-            double mem_usage = monitor_.GetMemoryUsage();
-            
             double cpu = monitor_.GetCpuUsage();
             double mem = monitor_.GetMemoryUsage();
+            PowerSample power_sample = power.Sample();
+            auto power_time = std::chrono::steady_clock::now();
             
             cpu_samples.push_back(cpu);
             mem_samples.push_back(mem);
+            // 多线程并发推理时每个 Run 各自持有激活内存，峰值只会出现在正式压测阶段。
+            // 每 500ms 采样一次堆，降低 mallinfo2 锁住所有 malloc arena 对 Worker 的干扰
+            if (sample_heap && monitor_ticks % 5 == 0) {
+                heap_peak_run = std::max(heap_peak_run, SystemMonitor::GetHeapInUseBytes());
+            }
+            monitor_ticks++;
 
-            // Watchdog Check
-            if (config.memory_limit_mb > 0 && mem > config.memory_limit_mb) {
-                std::cerr << "\n[Watchdog] OOM Detected! Current: " << mem 
-                          << " MB > Limit: " << config.memory_limit_mb << " MB. Stopping..." << std::endl;
-                monitor_running = false;
-                // Force stop all requests
-                remaining_requests = 0;
+            if (tracer) {
+                int64_t ts = since_origin_ns(std::chrono::steady_clock::now());
+                tracer->AddCounter("cpu_usage_pct", ts, cpu);
+                tracer->AddCounter("rss_mb", ts, mem);
+                if (power.HasFrequency()) {
+                    tracer->AddCounter("cpu_freq_mhz", ts, power_sample.avg_freq_mhz);
+                }
+                double dt = std::chrono::duration<double>(power_time - last_power_time).count();
+                if (power.HasEnergy() && dt > 0) {
+                    tracer->AddCounter("package_watts", ts, (power_sample.energy_joules - last_power.energy_joules) / dt);
+                }
+            }
+            last_power = power_sample;
+            last_power_time = power_time;
+
+            if (cgroup_available) {
+                cgroup_peak_bytes = std::max(cgroup_peak_bytes, cgroup.ReadMemoryStat().current_bytes);
+            }
+
+            // Watchdog Check (RSS)
+            // 持续超限时重复处置 (apply_watchdog_action 内有 1 秒冷却)，收缩一次后仍超限则继续收缩
+            bool over = config.memory_limit_mb > 0 && mem > config.memory_limit_mb;
+            if (over && remaining_requests.load(std::memory_order_relaxed) > 0) {
+                std::ostringstream reason;
+                reason << "OOM Detected! Current: " << mem 
+                       << " MB > Limit: " << config.memory_limit_mb << " MB.";
+                apply_watchdog_action(reason.str());
             }
 
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     });
 
+    // cgroup 看门狗：PSI / memory.events 事件驱动，内核越过阈值时立即唤醒
+    if (config.cgroup_watchdog) {
+        bool started = cgroup.Start(config.watchdog, [&](const WatchdogEvent& event) {
+            const char* source = event.source == WatchdogEvent::Source::kPsi ? "PSI memory pressure"
+                               : event.source == WatchdogEvent::Source::kMemoryEvents ? "cgroup memory event"
+                               : "cgroup memory ratio";
+            std::ostringstream reason;
+            reason << source << " (current " << event.memory.current_bytes / (1024.0 * 1024.0) << " MB).";
+            apply_watchdog_action(reason.str());
+        });
+        if (!started) {
+            std::cerr << "[Watchdog] cgroup v2 not available, falling back to RSS watchdog." << std::endl;
+        }
+    }
+
+    // 截止时间取消线程：每 1ms 扫描一次在途请求，超时则取消 (取消精度约 1ms)
+    std::atomic<bool> workers_running(true);
+    std::thread canceller_thread;
+    if (deadline_enabled) {
+        canceller_thread = std::thread([&]() {
+            while (workers_running) {
+                int64_t now = now_ns();
+                for (auto& slot : in_flight) {
+                    std::lock_guard<std::mutex> lock(slot->mutex);
+                    if (slot->deadline_ns > 0 && !slot->cancelled && now >= slot->deadline_ns) {
+                        slot->cancel.Cancel();
+                        slot->cancelled = true;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
     // 5. 启动 Worker 线程
-    auto start_time = std::chrono::high_resolution_clock::now();
+    power.Begin();
+    auto start_time = std::chrono::steady_clock::now();
+    int64_t start_ns = now_ns();
+    // 每个 Worker 取单循环本身的耗时 (不含线程创建与 join)，供框架开销标定使用
+    std::vector<int64_t> worker_loop_ns(config.threads, 0);
 
     for (int t = 0; t < config.threads; ++t) {
         threads.emplace_back([&, t]() {
+            auto loop_start = std::chrono::steady_clock::now();
             while (true) {
+                // 被看门狗收缩的 Worker 暂停取单，直到请求全部派发完
+                if (t >= active_workers.load(std::memory_order_relaxed)) {
+                    if (remaining_requests.load(std::memory_order_relaxed) <= 0) break;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+
                 // 抢单：原子减
                 // fetch_sub 返回修改前的值
                 int current_req_idx = remaining_requests.fetch_sub(1);
                 if (current_req_idx <= 0) {
                     break; // 抢没了，下班
                 }
+                dispatched_requests++;
 
-                auto t1 = std::chrono::high_resolution_clock::now();
-                engine_.Run(input_data);
-                auto t2 = std::chrono::high_resolution_clock::now();
+                // 到达时刻：开环模式取预生成的时刻 (未到则等待)，闭环模式即取单时刻
+                int64_t arrival_ns = now_ns();
+                if (!arrival_offsets_ns.empty()) {
+                    arrival_ns = start_ns + arrival_offsets_ns[config.requests - current_req_idx];
+                    int64_t wait_ns = arrival_ns - now_ns();
+                    if (wait_ns > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(wait_ns));
+                }
+                int64_t dequeue_ns = now_ns();
+                queue_ns_sum += std::max<int64_t>(dequeue_ns - arrival_ns, 0);
 
-                // 记录延迟 (毫秒)
-                double lat_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
-                all_thread_latencies[t].push_back(lat_ms);
+                // 准入控制：预计无法在截止时间前完成的请求直接拒绝，不占用推理资源
+                int64_t deadline_ns = arrival_ns + deadline_budget_ns;
+                bool admit = true;
+                bool probe = false;
+                if (deadline_enabled) {
+                    if (dequeue_ns + service_estimate_ns.load(std::memory_order_relaxed) > deadline_ns) {
+                        admit = probe = dequeue_ns < deadline_ns &&
+                                        consecutive_rejections.fetch_add(1) + 1 >= kAdmissionProbeInterval;
+                    }
+                    if (admit && consecutive_rejections.load(std::memory_order_relaxed) != 0) {
+                        consecutive_rejections.store(0, std::memory_order_relaxed);
+                    }
+                }
+                if (!admit) {
+                    rejected_requests++;
+                    if (tracer) {
+                        RequestSpan span;
+                        span.request_id = config.requests - current_req_idx;
+                        span.start_ns = arrival_ns;
+                        span.queue_ns = std::max<int64_t>(dequeue_ns - arrival_ns, 0);
+                        span.worker = t;
+                        span.status = kRequestRejected;
+                        tracer->Record(span);
+                    }
+                    if (request_log) {
+                        request_log->Append(t, {static_cast<uint64_t>(since_origin_ns(std::chrono::steady_clock::now())),
+                                                0, static_cast<uint32_t>(t), 0, kRequestRejected});
+                    }
+                    continue;
+                }
+
+                // 追踪模式下额外采集线程级计数 (getrusage 为系统调用，仅在开启时执行)
+                ThreadUsage usage_begin;
+                int cpu = -1;
+                if (tracer) {
+                    usage_begin = ThreadUsage::Capture();
+                    cpu = sched_getcpu();
+                }
+
+                InFlight* slot = deadline_enabled ? in_flight[t].get() : nullptr;
+                if (slot) {
+                    std::lock_guard<std::mutex> lock(slot->mutex);
+                    slot->cancel.Reset();
+                    slot->deadline_ns = deadline_ns;
+                    slot->cancelled = false;
+                }
+
+                RequestStatus status = kRequestOk;
+                auto t1 = std::chrono::steady_clock::now();
+                try {
+                    if (slot) engine_.Run(input_data, slot->cancel);
+                    else engine_.Run(input_data);
+                } catch (const std::exception&) {
+                    status = kRequestError;
+                }
+                auto t2 = std::chrono::steady_clock::now();
+                int64_t infer_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+
+                bool cancelled = false;
+                if (slot) {
+                    std::lock_guard<std::mutex> lock(slot->mutex);
+                    slot->deadline_ns = 0;
+                    cancelled = slot->cancelled;
+                }
+
+                if (status == kRequestOk) {
+                    // 记录延迟 (毫秒)
+                    all_thread_latencies[t].push_back(infer_ns / 1e6);
+                    if (deadline_enabled) {
+                        int64_t estimate = service_estimate_ns.load(std::memory_order_relaxed);
+                        // 探测请求比预估快时直接采用其耗时，否则 EWMA 需要很多个探测才能回落
+                        int64_t updated = probe && infer_ns < estimate ? infer_ns : estimate + (infer_ns - estimate) / 8;
+                        service_estimate_ns.store(updated, std::memory_order_relaxed);
+                        if (now_ns() > deadline_ns) status = kRequestTimeout; // 完成时已超时
+                        else goodput_requests++;
+                    }
+                } else if (cancelled) {
+                    status = kRequestTimeout;
+                }
+                if (status == kRequestTimeout) timeout_requests++;
+                else if (status == kRequestError) failed_requests++;
+
+                if (request_log) {
+                    request_log->Append(t, {static_cast<uint64_t>(since_origin_ns(t1)), static_cast<uint64_t>(infer_ns),
+                                            static_cast<uint32_t>(t), 0, status});
+                }
+
+                if (tracer) {
+                    ThreadUsage usage_end = ThreadUsage::Capture();
+                    auto t3 = std::chrono::steady_clock::now();
+
+                    RequestSpan span;
+                    span.request_id = config.requests - current_req_idx;
+                    span.start_ns = arrival_ns;
+                    span.queue_ns = std::max<int64_t>(dequeue_ns - arrival_ns, 0);
+                    span.dispatch_ns = since_origin_ns(t1) - (span.start_ns + span.queue_ns);
+                    span.infer_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+                    span.post_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count();
+                    span.worker = t;
+                    span.cpu = cpu;
+                    span.status = status;
+                    span.voluntary_ctx_switches = static_cast<int32_t>(usage_end.voluntary_ctx_switches - usage_begin.voluntary_ctx_switches);
+                    span.involuntary_ctx_switches = static_cast<int32_t>(usage_end.involuntary_ctx_switches - usage_begin.involuntary_ctx_switches);
+                    span.minor_faults = static_cast<int32_t>(usage_end.minor_faults - usage_begin.minor_faults);
+                    span.major_faults = static_cast<int32_t>(usage_end.major_faults - usage_begin.major_faults);
+                    tracer->Record(span);
+                }
             }
+            worker_loop_ns[t] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - loop_start).count();
         });
     }
 
@@ -91,13 +435,92 @@ BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
     for (auto& t : threads) {
         if (t.joinable()) t.join();
     }
+    worker_loop_ns_ = std::accumulate(worker_loop_ns.begin(), worker_loop_ns.end(), int64_t{0});
 
-    auto end_time = std::chrono::high_resolution_clock::now();
+    auto end_time = std::chrono::steady_clock::now();
+    power.End();
     double total_time_sec = std::chrono::duration<double>(end_time - start_time).count();
 
+    workers_running = false;
+    if (canceller_thread.joinable()) canceller_thread.join();
+
     // 7. 停止监控
+    cgroup.Stop();
     monitor_running = false;
     if (monitor_thread.joinable()) monitor_thread.join();
+    PowerSummary power_summary = power.Summarize();
+
+    if (request_log) {
+        request_log->Close();
+        if (!calibrating_) {
+            std::cout << "[RequestLog] " << request_log->GetRecordCount() << " records saved to "
+                      << config.request_log_path << std::endl;
+        }
+    }
+
+    if (tracer && !calibrating_) {
+        if (tracer->ExportChromeTrace(config.trace_path)) {
+            std::cout << "[Trace] Saved to " << config.trace_path;
+            if (tracer->GetDroppedCount() > 0) {
+                std::cout << " (" << tracer->GetDroppedCount() << " oldest spans overwritten)";
+            }
+            std::cout << std::endl;
+        } else {
+            std::cerr << "[Error] Failed to save trace to " << config.trace_path << std::endl;
+        }
+    }
+
+    // 内存行为
+    AllocatorStats alloc_after_run = engine_.GetAllocatorStats();
+    result.session_memory_mb = engine_.GetSessionMemoryBytes() / (1024.0 * 1024.0);
+    if (alloc_after_run.available) {
+        result.arena_peak_mb = (alloc_after_run.peak_bytes - alloc_before_warmup.in_use_bytes) / (1024.0 * 1024.0);
+        int64_t completed = 0;
+        for (const auto& local_lats : all_thread_latencies) completed += local_lats.size();
+        if (completed > 0) {
+            result.alloc_per_inference_kb =
+                (alloc_after_run.total_allocated_bytes - alloc_before_run.total_allocated_bytes) / 1024.0 / completed;
+        }
+    } else {
+        // 预热阶段尚未创建框架缓冲区；正式压测阶段的峰值需扣除框架缓冲区
+        int64_t peak = std::max(heap_peak_warmup - heap_before_warmup,
+                                heap_peak_run - heap_before_warmup - harness_heap_bytes);
+        result.arena_peak_mb = std::max<int64_t>(peak, 0) / (1024.0 * 1024.0);
+        result.arena_peak_approximate = true;
+    }
+
+    result.failed_requests = failed_requests;
+    if (dispatched_requests > 0) {
+        result.avg_queue_ms = queue_ns_sum / 1e6 / dispatched_requests;
+    }
+    if (deadline_enabled) {
+        result.rejected_requests = rejected_requests;
+        result.timeout_requests = timeout_requests;
+        result.goodput_qps = goodput_requests / total_time_sec;
+        if (dispatched_requests > 0) {
+            result.rejection_rate = static_cast<double>(rejected_requests) / dispatched_requests;
+            result.timeout_rate = static_cast<double>(timeout_requests) / dispatched_requests;
+        }
+    }
+
+    result.watchdog_triggers = watchdog_triggers;
+    result.aborted = aborted;
+    result.final_concurrency = active_workers;
+
+    if (cgroup_available) {
+        CgroupCpuStat cpu_stat_end = cgroup.ReadCpuStat();
+        CgroupMemoryStat mem_stat_end = cgroup.ReadMemoryStat();
+        int64_t periods = cpu_stat_end.nr_periods - cpu_stat_begin.nr_periods;
+
+        result.cgroup_available = true;
+        result.cgroup_peak_memory_mb = std::max(cgroup_peak_bytes, mem_stat_end.current_bytes) / (1024.0 * 1024.0);
+        result.cgroup_memory_max_mb = mem_stat_end.max_bytes > 0 ? mem_stat_end.max_bytes / (1024.0 * 1024.0) : 0.0;
+        result.cgroup_oom_events = mem_stat_end.events_oom - mem_stat_begin.events_oom;
+        result.cpu_quota_cores = cgroup.GetCpuQuotaCores();
+        result.cpu_nr_throttled = cpu_stat_end.nr_throttled - cpu_stat_begin.nr_throttled;
+        result.cpu_throttled_ms = (cpu_stat_end.throttled_usec - cpu_stat_begin.throttled_usec) / 1000.0;
+        result.cpu_throttled_ratio = periods > 0 ? static_cast<double>(result.cpu_nr_throttled) / periods : 0.0;
+    }
 
     // 8. 汇总数据
     // 合并 Latency
@@ -107,8 +530,9 @@ BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
         flat_latencies.insert(flat_latencies.end(), local_lats.begin(), local_lats.end());
     }
 
-    // 计算统计指标
-    result.qps = config.requests / total_time_sec;
+    // 计算统计指标 (以实际完成数计算，看门狗可能提前停止派发)
+    result.completed_requests = static_cast<int>(flat_latencies.size());
+    result.qps = result.completed_requests / total_time_sec;
     
     if (!flat_latencies.empty()) {
         double sum = std::accumulate(flat_latencies.begin(), flat_latencies.end(), 0.0);
@@ -116,6 +540,26 @@ BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
         result.p99_latency_ms = CalculatePercentile(flat_latencies, 0.99);
     }
 
+    // 能耗与频率
+    if (power.HasEnergy()) {
+        result.energy_available = true;
+        result.energy_joules = power_summary.energy_joules;
+        result.avg_power_watts = power_summary.duration_sec > 0 ? power_summary.energy_joules / power_summary.duration_sec : 0.0;
+        if (result.completed_requests > 0) {
+            result.joules_per_inference = power_summary.energy_joules / result.completed_requests;
+        }
+        if (power_summary.energy_joules > 0) {
+            result.queries_per_joule = result.completed_requests / power_summary.energy_joules;
+        }
+    }
+    if (power.HasFrequency()) {
+        result.freq_available = true;
+        result.avg_freq_mhz = power_summary.avg_freq_mhz;
+        result.min_freq_mhz = power_summary.min_freq_mhz;
+        result.below_base_events = power_summary.below_base_events;
+    }
+    result.throttle_events = power_summary.throttle_events;
+
     if (!cpu_samples.empty()) {
         double sum = std::accumulate(cpu_samples.begin(), cpu_samples.end(), 0.0);
         result.avg_cpu_usage = sum / cpu_samples.size();
@@ -126,9 +570,51 @@ BenchmarkResult BenchmarkRunner::Run(const BenchmarkConfig& config) {
         result.peak_memory_mb = *std::max_element(mem_samples.begin(), mem_samples.end());
     }
 
+    // 9. 框架开销标定 (在主压测结束后进行，不影响上面的数据)
+    // 请求数不超过主压测，避免小规模压测被标定拖慢
+    int calibration_requests = std::min(config.harness_calibration_requests, config.requests);
+    if (calibration_requests > 0 && result.completed_requests > 0) {
+        HarnessOverhead overhead = MeasureHarnessOverhead(config, input_size, calibration_requests);
+        result.harness_latency_us = overhead.latency_us;
+        result.harness_request_us = overhead.request_us;
+        if (result.avg_latency_ms > 0) {
+            result.harness_overhead_pct = result.harness_request_us / (result.avg_latency_ms * 1000.0) * 100.0;
+        }
+    }
+
     return result;
 }
 
+HarnessOverhead BenchmarkRunner::MeasureHarnessOverhead(const BenchmarkConfig& config, int64_t input_size, int requests) {
+    NullEngine null_engine(input_size);
+    BenchmarkRunner runner(null_engine, monitor_);
+    runner.calibrating_ = true;
+
+    BenchmarkConfig calibration;
+    calibration.threads = config.threads;
+    calibration.requests = requests;
+    calibration.warmup_rounds = 100;
+    calibration.deadline_ms = config.deadline_ms; // 截止时间会引入在途登记与取消线程的开销
+    calibration.harness_calibration_requests = 0;
+    // Trace 与请求日志同样在每个请求上产生开销：Trace 照常记录但不导出，请求日志写到临时文件后删除
+    calibration.trace_path = config.trace_path;
+    calibration.trace_capacity = config.trace_capacity;
+    if (!config.request_log_path.empty()) {
+        calibration.request_log_path = config.request_log_path + ".calibration";
+    }
+
+    BenchmarkResult r = runner.Run(calibration);
+    if (!calibration.request_log_path.empty()) {
+        std::remove(calibration.request_log_path.c_str());
+    }
+
+    HarnessOverhead overhead;
+    overhead.latency_us = r.avg_latency_ms * 1000.0;
+    // 各 Worker 取单循环耗时之和 / 请求数 = 单个 Worker 处理一个请求的耗时 (不含线程启动等固定开销)
+    overhead.request_us = requests > 0 ? runner.worker_loop_ns_ / 1e3 / requests : 0.0;
+    return overhead;
+}
+
 double BenchmarkRunner::CalculatePercentile(std::vector<double>& latencies, double percentile) {
     if (latencies.empty()) return 0.0;
     
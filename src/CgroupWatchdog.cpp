@@ -0,0 +1,267 @@
+#include "CgroupWatchdog.h"
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+// 在 "key value\n" 格式的内容中查找 key 对应的整数值 (memory.stat / memory.events / cpu.stat)
+int64_t ParseKeyedValue(const std::string& content, const std::string& key) {
+    std::istringstream iss(content);
+    std::string name;
+    int64_t value = 0;
+    while (iss >> name >> value) {
+        if (name == key) return value;
+    }
+    return 0;
+}
+
+// 解析单值文件 (memory.current / memory.max)，"max" 返回 -1
+int64_t ParseSingleValue(const std::string& content, int64_t fallback) {
+    if (content.empty()) return fallback;
+    if (content.compare(0, 3, "max") == 0) return -1;
+    try {
+        return std::stoll(content);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+} // namespace
+
+CgroupWatchdog::CgroupWatchdog(const std::string& cgroup_dir)
+    : path_(cgroup_dir.empty() ? DetectCgroupPath() : cgroup_dir) {}
+
+CgroupWatchdog::~CgroupWatchdog() {
+    Stop();
+}
+
+bool CgroupWatchdog::IsAvailable() const {
+    if (path_.empty()) return false;
+    // memory.current 与 cpu.stat 只存在于 cgroup v2
+    return access((path_ + "/memory.current").c_str(), R_OK) == 0 ||
+           access((path_ + "/cpu.stat").c_str(), R_OK) == 0;
+}
+
+std::string CgroupWatchdog::ReadFile(const char* name) const {
+    if (path_.empty()) return "";
+    std::ifstream file(path_ + "/" + name);
+    if (!file.is_open()) return "";
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+CgroupMemoryStat CgroupWatchdog::ReadMemoryStat() const {
+    CgroupMemoryStat stat;
+    stat.current_bytes = ParseSingleValue(ReadFile("memory.current"), 0);
+    stat.max_bytes = ParseSingleValue(ReadFile("memory.max"), -1);
+
+    std::string mem_stat = ReadFile("memory.stat");
+    stat.anon_bytes = ParseKeyedValue(mem_stat, "anon");
+    stat.file_bytes = ParseKeyedValue(mem_stat, "file");
+
+    std::string events = ReadFile("memory.events");
+    stat.events_high = ParseKeyedValue(events, "high");
+    stat.events_max = ParseKeyedValue(events, "max");
+    stat.events_oom = ParseKeyedValue(events, "oom");
+    stat.events_oom_kill = ParseKeyedValue(events, "oom_kill");
+    return stat;
+}
+
+CgroupCpuStat CgroupWatchdog::ReadCpuStat() const {
+    CgroupCpuStat stat;
+    std::string content = ReadFile("cpu.stat");
+    stat.usage_usec = ParseKeyedValue(content, "usage_usec");
+    stat.nr_periods = ParseKeyedValue(content, "nr_periods");
+    stat.nr_throttled = ParseKeyedValue(content, "nr_throttled");
+    stat.throttled_usec = ParseKeyedValue(content, "throttled_usec");
+    return stat;
+}
+
+double CgroupWatchdog::GetCpuQuotaCores() const {
+    // cpu.max 格式: "<quota|max> <period>"
+    std::istringstream iss(ReadFile("cpu.max"));
+    std::string quota;
+    int64_t period = 0;
+    if (!(iss >> quota >> period) || quota == "max" || period <= 0) {
+        return 0.0;
+    }
+    try {
+        return static_cast<double>(std::stoll(quota)) / static_cast<double>(period);
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+}
+
+std::string CgroupWatchdog::DetectCgroupPath() {
+    // 1. /proc/self/cgroup 中 cgroup v2 的行形如 "0::/kubepods/pod-xxx/..."
+    std::ifstream cgroup_file("/proc/self/cgroup");
+    std::string line;
+    std::string cgroup_path;
+    bool found = false;
+    while (std::getline(cgroup_file, line)) {
+        if (line.compare(0, 3, "0::") == 0) {
+            cgroup_path = line.substr(3);
+            found = true;
+            break;
+        }
+    }
+    if (!found) return "";
+
+    // 2. /proc/self/mountinfo 中找到 cgroup2 的挂载点
+    // 格式: "<id> <parent> <dev> <root> <mount_point> <opts> ... - <fstype> <source> <opts>"
+    std::ifstream mountinfo("/proc/self/mountinfo");
+    while (std::getline(mountinfo, line)) {
+        size_t sep = line.find(" - ");
+        if (sep == std::string::npos) continue;
+        std::istringstream tail(line.substr(sep + 3));
+        std::string fstype;
+        tail >> fstype;
+        if (fstype != "cgroup2") continue;
+
+        std::istringstream head(line.substr(0, sep));
+        std::string id, parent, dev, root, mount_point;
+        head >> id >> parent >> dev >> root >> mount_point;
+
+        // 挂载根不是 "/" 时 (cgroup namespace / bind mount)，需要去掉公共前缀
+        std::string relative = cgroup_path;
+        if (root != "/" && relative.compare(0, root.size(), root) == 0) {
+            relative = relative.substr(root.size());
+        }
+        if (relative == "/") relative.clear();
+        return mount_point + relative;
+    }
+    return "";
+}
+
+bool CgroupWatchdog::Start(const WatchdogOptions& options, Callback on_trigger) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (thread_.joinable() || !IsAvailable()) {
+        return false;
+    }
+    options_ = options;
+    on_trigger_ = std::move(on_trigger);
+
+    stop_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stop_fd_ < 0) {
+        return false;
+    }
+
+    // 注册 PSI 触发器: 写入 "some <stall_us> <window_us>"，之后内核会在
+    // 窗口内停顿时间超过阈值时对该 fd 产生 POLLPRI
+    if (options_.psi_stall_us > 0) {
+        std::string pressure_path = path_ + "/memory.pressure";
+        psi_fd_ = open(pressure_path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (psi_fd_ >= 0) {
+            std::string trigger = "some " + std::to_string(options_.psi_stall_us) + " " +
+                                  std::to_string(options_.psi_window_us);
+            if (write(psi_fd_, trigger.c_str(), trigger.size() + 1) < 0) {
+                std::cerr << "[Watchdog] Failed to register PSI trigger: " << strerror(errno) << std::endl;
+                close(psi_fd_);
+                psi_fd_ = -1;
+            }
+        } else {
+            std::cerr << "[Watchdog] PSI unavailable (" << pressure_path << "): " << strerror(errno) << std::endl;
+        }
+    }
+
+    // memory.events 是 kernfs 文件，计数变化时会唤醒 poll (POLLPRI)
+    std::string events_path = path_ + "/memory.events";
+    events_fd_ = open(events_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    thread_ = std::thread(&CgroupWatchdog::WatchLoop, this);
+    return true;
+}
+
+void CgroupWatchdog::Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (thread_.joinable()) {
+        uint64_t one = 1;
+        ssize_t ret = write(stop_fd_, &one, sizeof(one));
+        (void)ret;
+        thread_.join();
+    }
+    if (psi_fd_ >= 0) { close(psi_fd_); psi_fd_ = -1; }
+    if (events_fd_ >= 0) { close(events_fd_); events_fd_ = -1; }
+    if (stop_fd_ >= 0) { close(stop_fd_); stop_fd_ = -1; }
+}
+
+void CgroupWatchdog::WatchLoop() {
+    using Clock = std::chrono::steady_clock;
+    const auto cooldown = std::chrono::microseconds(options_.psi_window_us);
+
+    CgroupMemoryStat last = ReadMemoryStat();
+    Clock::time_point last_ratio_fire{};
+    char drain[512];
+
+    while (true) {
+        pollfd fds[3];
+        nfds_t nfds = 0;
+        fds[nfds++] = {stop_fd_, POLLIN, 0};
+        int psi_idx = -1, events_idx = -1;
+        if (psi_fd_ >= 0) { psi_idx = static_cast<int>(nfds); fds[nfds++] = {psi_fd_, POLLPRI, 0}; }
+        if (events_fd_ >= 0) { events_idx = static_cast<int>(nfds); fds[nfds++] = {events_fd_, POLLPRI, 0}; }
+
+        int ret = poll(fds, nfds, options_.poll_interval_ms);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            break; // Stop() 请求退出
+        }
+
+        WatchdogEvent event;
+        bool fire = false;
+
+        if (psi_idx >= 0 && fds[psi_idx].revents) {
+            if (fds[psi_idx].revents & POLLERR) {
+                // cgroup 已被删除，触发器失效
+                close(psi_fd_);
+                psi_fd_ = -1;
+            } else if (fds[psi_idx].revents & POLLPRI) {
+                event.source = WatchdogEvent::Source::kPsi;
+                fire = true;
+            }
+        }
+
+        CgroupMemoryStat stat = ReadMemoryStat();
+
+        if (events_idx >= 0 && fds[events_idx].revents) {
+            // 必须通过同一个 fd 重新读取，内核才会清除通知状态
+            if (lseek(events_fd_, 0, SEEK_SET) < 0 || read(events_fd_, drain, sizeof(drain)) < 0) {
+                close(events_fd_);
+                events_fd_ = -1;
+            }
+            if (!fire && (stat.events_high > last.events_high || stat.events_max > last.events_max ||
+                          stat.events_oom > last.events_oom)) {
+                event.source = WatchdogEvent::Source::kMemoryEvents;
+                fire = true;
+            }
+        }
+
+        if (!fire && options_.memory_ratio > 0 && stat.max_bytes > 0 &&
+            stat.current_bytes >= options_.memory_ratio * static_cast<double>(stat.max_bytes)) {
+            auto now = Clock::now();
+            if (now - last_ratio_fire >= cooldown) {
+                last_ratio_fire = now;
+                event.source = WatchdogEvent::Source::kMemoryRatio;
+                fire = true;
+            }
+        }
+
+        last = stat;
+        if (fire && on_trigger_) {
+            event.memory = stat;
+            on_trigger_(event);
+        }
+    }
+}
@@ -0,0 +1,250 @@
+#include "ColdStartRunner.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <fcntl.h>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 依次执行 count 个请求，返回每个请求的延迟 (毫秒)
+std::vector<double> RunSequential(Engine& engine, const std::vector<float>& input, int count) {
+    std::vector<double> latencies;
+    latencies.reserve(std::max(count, 0));
+    for (int i = 0; i < count; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        engine.Run(input);
+        latencies.push_back(MillisecondsSince(start));
+    }
+    return latencies;
+}
+
+// 各次重复中第 i 个请求的平均延迟
+std::vector<double> MeanCurve(const std::vector<ColdStartSample>& samples,
+                              std::vector<double> ColdStartSample::*field) {
+    std::vector<double> curve;
+    std::vector<int> counts;
+    for (const auto& sample : samples) {
+        const auto& values = sample.*field;
+        if (values.size() > curve.size()) {
+            curve.resize(values.size(), 0.0);
+            counts.resize(values.size(), 0);
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+            curve[i] += values[i];
+            counts[i]++;
+        }
+    }
+    for (size_t i = 0; i < curve.size(); ++i) curve[i] /= counts[i];
+    return curve;
+}
+
+// 本进程驻留的匿名内存 (/proc/self/smaps_rollup 的 Anonymous 行)，读取失败返回 -1
+int64_t ReadAnonymousResidentBytes() {
+    std::ifstream rollup("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(rollup, line)) {
+        if (line.compare(0, 10, "Anonymous:") == 0) {
+            return std::stoll(line.substr(10)) * 1024; // 单位 kB
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+ColdStartRunner::ColdStartRunner(EngineFactory factory, const std::string& model_path)
+    : factory_(std::move(factory)), model_path_(model_path) {}
+
+ColdStartResult ColdStartRunner::Run(const ColdStartConfig& config) {
+    ColdStartResult result;
+    const bool recovery = config.idle_ms > 0 || config.flush_cache || config.evict_pages;
+
+#if defined(__GLIBC__)
+    // 换出依赖“加载前后新增的映射”找出引擎的内存。glibc 默认动态调整 mmap 阈值：
+    // 上一次重复释放大块后阈值被抬高，之后的大块改从已映射的堆中分配，不再表现为新增映射。
+    // 显式设置阈值会关闭动态调整，使大块始终单独 mmap；该设置对整个进程生效且无法查询旧值，
+    // 因此不恢复 (--cold_start 独占进程)。
+    if (config.evict_pages) mallopt(M_MMAP_THRESHOLD, 128 * 1024);
+#endif
+
+    for (int rep = 0; rep < config.repetitions; ++rep) {
+        ColdStartSample sample;
+
+        // 1. 加载：每次重复都重新创建引擎
+        // 换出模式下在加载前后各取一次匿名映射快照，只换出引擎带来的那部分内存
+        std::vector<AddressRange> maps_before;
+        if (config.evict_pages) maps_before = SnapshotAnonymousMappings();
+        if (config.evict_pages && !model_path_.empty()) DropFileCache(model_path_);
+        auto load_start = std::chrono::steady_clock::now();
+        std::unique_ptr<Engine> engine = factory_();
+        sample.load_ms = MillisecondsSince(load_start);
+
+        // 输入生成不计入任何阶段
+        std::vector<float> input(engine->GetInputSize());
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (auto& val : input) val = dist(gen);
+
+        // 2. 冷启动曲线
+        sample.latencies_ms = RunSequential(*engine, input, config.first_requests);
+        // 首个请求才分配 arena，因此在冷启动曲线之后取第二次快照
+        std::vector<AddressRange> engine_ranges;
+        if (config.evict_pages) engine_ranges = SubtractRanges(SnapshotAnonymousMappings(), maps_before);
+
+        // 3. 空闲恢复曲线
+        if (recovery) {
+            if (config.idle_ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(config.idle_ms));
+            if (config.flush_cache) FlushCaches(config.flush_bytes);
+            if (config.evict_pages) sample.evicted_bytes = EvictAnonymousPages(engine_ranges);
+            sample.recovery_ms = RunSequential(*engine, input, config.first_requests);
+        }
+
+        engine.reset(); // 析构不计时
+#if defined(__GLIBC__)
+        // 归还堆顶与 arena 中的空闲页，下一次重复的分配才会重新出现在新增区间里
+        if (config.evict_pages) malloc_trim(0);
+#endif
+        result.samples.push_back(std::move(sample));
+    }
+
+    // 4. 汇总
+    std::vector<double> loads, firsts, recovery_firsts;
+    for (const auto& sample : result.samples) {
+        loads.push_back(sample.load_ms);
+        if (!sample.latencies_ms.empty()) firsts.push_back(sample.latencies_ms.front());
+        if (!sample.recovery_ms.empty()) recovery_firsts.push_back(sample.recovery_ms.front());
+    }
+    result.load_ms = Summarize(loads);
+    result.first_ms = Summarize(firsts);
+    result.recovery_first_ms = Summarize(recovery_firsts);
+    result.curve_ms = MeanCurve(result.samples, &ColdStartSample::latencies_ms);
+    result.recovery_curve_ms = MeanCurve(result.samples, &ColdStartSample::recovery_ms);
+
+    if (!result.curve_ms.empty()) {
+        size_t half = result.curve_ms.size() / 2;
+        double sum = 0.0;
+        for (size_t i = half; i < result.curve_ms.size(); ++i) sum += result.curve_ms[i];
+        result.warm_ms = sum / (result.curve_ms.size() - half);
+    }
+    return result;
+}
+
+ColdStartStats ColdStartRunner::Summarize(const std::vector<double>& values) {
+    ColdStartStats stats;
+    if (values.empty()) return stats;
+
+    double sum = 0.0;
+    stats.min = stats.max = values.front();
+    for (double v : values) {
+        sum += v;
+        stats.min = std::min(stats.min, v);
+        stats.max = std::max(stats.max, v);
+    }
+    stats.mean = sum / values.size();
+    if (values.size() > 1) {
+        double sq = 0.0;
+        for (double v : values) sq += (v - stats.mean) * (v - stats.mean);
+        stats.stddev = std::sqrt(sq / (values.size() - 1));
+    }
+    return stats;
+}
+
+void ColdStartRunner::FlushCaches(size_t bytes) {
+    if (bytes == 0) {
+        long llc = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+        const size_t kMin = 64u << 20, kMax = 1u << 30;
+        bytes = std::min(std::max(llc > 0 ? static_cast<size_t>(llc) * 2 : 0, kMin), kMax);
+    }
+
+    // 先写后读，按缓存行步进；写入保证页已分配，读取把整个缓冲区过一遍缓存
+    std::vector<char> buffer(bytes);
+    for (size_t i = 0; i < bytes; i += 64) buffer[i] = static_cast<char>(i);
+    volatile char sink = 0;
+    for (size_t i = 0; i < bytes; i += 64) sink = sink + buffer[i];
+}
+
+bool ColdStartRunner::DropFileCache(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return ok;
+}
+
+std::vector<AddressRange> ColdStartRunner::SnapshotAnonymousMappings() {
+    std::vector<AddressRange> ranges;
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line)) {
+        // 格式: begin-end perms offset dev inode [path]
+        std::istringstream fields(line);
+        std::string range, perms, offset, dev, path;
+        uint64_t inode = 0;
+        fields >> range >> perms >> offset >> dev >> inode;
+        std::getline(fields >> std::ws, path);
+        if (perms.size() < 4 || perms[0] != 'r' || perms[1] != 'w' || perms[3] != 'p') continue;
+        if (inode != 0 || (!path.empty() && path != "[heap]")) continue; // 仅匿名映射与堆
+
+        size_t dash = range.find('-');
+        if (dash == std::string::npos) continue;
+        ranges.push_back({static_cast<uintptr_t>(std::stoull(range.substr(0, dash), nullptr, 16)),
+                          static_cast<uintptr_t>(std::stoull(range.substr(dash + 1), nullptr, 16))});
+    }
+    return ranges;
+}
+
+std::vector<AddressRange> ColdStartRunner::SubtractRanges(const std::vector<AddressRange>& after,
+                                                          const std::vector<AddressRange>& before) {
+    std::vector<AddressRange> result;
+    for (const auto& a : after) {
+        uintptr_t cursor = a.begin;
+        for (const auto& b : before) {
+            if (b.end <= cursor) continue;
+            if (b.begin >= a.end) break;
+            if (b.begin > cursor) result.push_back({cursor, b.begin});
+            cursor = std::max(cursor, b.end);
+            if (cursor >= a.end) break;
+        }
+        if (cursor < a.end) result.push_back({cursor, a.end});
+    }
+    return result;
+}
+
+int64_t ColdStartRunner::EvictAnonymousPages(const std::vector<AddressRange>& ranges) {
+#ifdef MADV_PAGEOUT
+    int64_t resident_before = ReadAnonymousResidentBytes();
+
+    // 逐段提交；被锁定等特殊映射会返回 EINVAL，跳过即可
+    bool any_success = false;
+    for (const auto& r : ranges) {
+        if (madvise(reinterpret_cast<void*>(r.begin), r.end - r.begin, MADV_PAGEOUT) == 0) {
+            any_success = true;
+        }
+    }
+    if (!any_success && !ranges.empty()) return -1;
+
+    int64_t resident_after = ReadAnonymousResidentBytes();
+    if (resident_before < 0 || resident_after < 0) return 0;
+    return std::max<int64_t>(resident_before - resident_after, 0);
+#else
+    (void)ranges;
+    return -1;
+#endif
+}
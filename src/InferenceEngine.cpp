@@ -1,15 +1,160 @@
 #include "InferenceEngine.h"
+#include "SystemMonitor.h"
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <vector>
 #include <cstring>
 
+namespace {
+
+// 计数分配器：实现 OrtAllocator 的 C 接口，统计分配量后转交 aligned_alloc。
+// 每块内存前预留一个对齐头部保存块大小，以便 Free 时扣减统计。
+class TrackingAllocator : public OrtAllocator {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    TrackingAllocator()
+        : OrtAllocator{}, memory_info_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)) {
+        version = ORT_API_VERSION;
+        OrtAllocator::Alloc = &TrackingAllocator::AllocImpl;
+        OrtAllocator::Free = &TrackingAllocator::FreeImpl;
+        OrtAllocator::Info = &TrackingAllocator::InfoImpl;
+    }
+
+    AllocatorStats GetStats() const {
+        AllocatorStats stats;
+        stats.available = true;
+        stats.in_use_bytes = in_use_bytes_.load(std::memory_order_relaxed);
+        stats.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+        stats.total_allocated_bytes = total_allocated_bytes_.load(std::memory_order_relaxed);
+        stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    static void* ORT_API_CALL AllocImpl(OrtAllocator* self, size_t size) {
+        auto* tracker = static_cast<TrackingAllocator*>(self);
+        // aligned_alloc 要求大小为对齐值的整数倍
+        size_t total = (size + kAlignment + kAlignment - 1) / kAlignment * kAlignment;
+        void* block = std::aligned_alloc(kAlignment, total);
+        if (block == nullptr) return nullptr;
+        *static_cast<size_t*>(block) = size;
+
+        int64_t bytes = static_cast<int64_t>(size);
+        int64_t now = tracker->in_use_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        int64_t peak = tracker->peak_bytes_.load(std::memory_order_relaxed);
+        while (now > peak && !tracker->peak_bytes_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+        }
+        tracker->total_allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        tracker->num_allocs_.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<char*>(block) + kAlignment;
+    }
+
+    static void ORT_API_CALL FreeImpl(OrtAllocator* self, void* p) {
+        if (p == nullptr) return;
+        auto* tracker = static_cast<TrackingAllocator*>(self);
+        void* block = static_cast<char*>(p) - kAlignment;
+        tracker->in_use_bytes_.fetch_sub(static_cast<int64_t>(*static_cast<size_t*>(block)),
+                                         std::memory_order_relaxed);
+        std::free(block);
+    }
+
+    static const OrtMemoryInfo* ORT_API_CALL InfoImpl(const OrtAllocator* self) {
+        return static_cast<const TrackingAllocator*>(self)->memory_info_;
+    }
+
+    Ort::MemoryInfo memory_info_;
+    std::atomic<int64_t> in_use_bytes_{0};
+    std::atomic<int64_t> peak_bytes_{0};
+    std::atomic<int64_t> total_allocated_bytes_{0};
+    std::atomic<int64_t> num_allocs_{0};
+};
+
+// 进程级单例。Session 可能在任意时刻仍引用它，因此有意不析构。
+TrackingAllocator& GetTrackingAllocator() {
+    static TrackingAllocator* instance = new TrackingAllocator();
+    return *instance;
+}
+
+// 已注册到 Env 的分配器配置。Env 是进程内单例，只能注册一个 CPU 分配器，
+// 记录下来以便发现后续引擎请求了不同的配置 (否则它会静默沿用别人的分配器)。
+std::mutex g_env_allocator_mutex;
+bool g_env_allocator_registered = false;
+MemoryOptions g_env_allocator_config;
+int g_env_allocator_users = 0; // 仍在使用 Env 分配器的 InferenceEngine 数
+
+bool SameAllocatorConfig(const MemoryOptions& a, const MemoryOptions& b) {
+    if (a.allocator != b.allocator) return false;
+    if (a.allocator != AllocatorMode::kSharedArena) return true;
+    return a.arena_extend_strategy == b.arena_extend_strategy &&
+           a.arena_initial_chunk_bytes == b.arena_initial_chunk_bytes &&
+           a.arena_max_mem_bytes == b.arena_max_mem_bytes;
+}
+
+const char* AllocatorModeName(AllocatorMode mode) {
+    switch (mode) {
+        case AllocatorMode::kSharedArena: return "shared";
+        case AllocatorMode::kTracking: return "tracking";
+        case AllocatorMode::kSession:
+        default: return "session";
+    }
+}
+
+std::runtime_error AllocatorMismatch(const MemoryOptions& requested) {
+    return std::runtime_error(std::string("Shared allocator already registered in this process as '") +
+                              AllocatorModeName(g_env_allocator_config.allocator) +
+                              "' with a different configuration; cannot use '" +
+                              AllocatorModeName(requested.allocator) + "'");
+}
+
+// 向 Env 注册进程级共享分配器，并登记一个使用者 (由 ReleaseEnvAllocator 注销)。
+// 已注册过相同配置时 ONNX Runtime 返回 ORT_INVALID_ARGUMENT，沿用即可；配置不同则抛出异常。
+void RegisterEnvAllocator(Ort::Env& env, const MemoryOptions& memory) {
+    std::lock_guard<std::mutex> lock(g_env_allocator_mutex);
+    // 仍有引擎在用时 Env 一定还活着，已注册的分配器不可能被替换
+    if (g_env_allocator_users > 0 && !SameAllocatorConfig(g_env_allocator_config, memory)) {
+        throw AllocatorMismatch(memory);
+    }
+    try {
+        if (memory.allocator == AllocatorMode::kSharedArena) {
+            Ort::ArenaCfg arena_cfg(memory.arena_max_mem_bytes, memory.arena_extend_strategy,
+                                    memory.arena_initial_chunk_bytes, -1);
+            auto cpu_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            env.CreateAndRegisterAllocator(cpu_info, arena_cfg);
+        } else {
+            Ort::ThrowOnError(Ort::GetApi().RegisterAllocator(env, &GetTrackingAllocator()));
+        }
+        g_env_allocator_registered = true;
+        g_env_allocator_config = memory;
+    } catch (const Ort::Exception& e) {
+        if (e.GetOrtErrorCode() != ORT_INVALID_ARGUMENT) {
+            throw std::runtime_error("Failed to register shared allocator: " + std::string(e.what()));
+        }
+        // Env 被其他 (kSession 模式的) 引擎保活，之前的注册仍然有效
+        if (g_env_allocator_registered && !SameAllocatorConfig(g_env_allocator_config, memory)) {
+            throw AllocatorMismatch(memory);
+        }
+    }
+    g_env_allocator_users++;
+}
+
+void ReleaseEnvAllocator() {
+    std::lock_guard<std::mutex> lock(g_env_allocator_mutex);
+    g_env_allocator_users--;
+}
+
+} // namespace
+
 InferenceEngine::InferenceEngine() 
     : env_(ORT_LOGGING_LEVEL_WARNING, "InferBench") {
 }
 
 InferenceEngine::~InferenceEngine() {
+    if (uses_env_allocator_) ReleaseEnvAllocator();
     for (auto name : input_node_names_) {
         free(const_cast<char*>(name));
     }
@@ -18,7 +163,7 @@ InferenceEngine::~InferenceEngine() {
     }
 }
 
-void InferenceEngine::LoadModel(const std::string& model_path, int opt_level) {
+void InferenceEngine::LoadModel(const std::string& model_path, int opt_level, const MemoryOptions& memory) {
     // Clear previous model resources if any
     for (auto name : input_node_names_) free(const_cast<char*>(name));
     for (auto name : output_node_names_) free(const_cast<char*>(name));
@@ -47,11 +192,39 @@ void InferenceEngine::LoadModel(const std::string& model_path, int opt_level) {
 
     session_options.SetIntraOpNumThreads(1);
 
+    // 内存配置
+    if (memory.enable_mem_pattern) {
+        session_options.EnableMemPattern();
+    } else {
+        session_options.DisableMemPattern();
+    }
+    if (uses_env_allocator_) {
+        ReleaseEnvAllocator(); // 重复加载时先注销上一次的登记
+        uses_env_allocator_ = false;
+    }
+    if (memory.allocator == AllocatorMode::kSession) {
+        if (memory.enable_cpu_mem_arena) {
+            session_options.EnableCpuMemArena();
+        } else {
+            session_options.DisableCpuMemArena();
+        }
+    } else {
+        // 使用注册到 Env 的进程级分配器代替 Session 自己的 arena
+        RegisterEnvAllocator(env_, memory);
+        uses_env_allocator_ = true;
+        session_options.AddConfigEntry("session.use_env_allocators", "1");
+    }
+    allocator_mode_ = memory.allocator;
+
+    int64_t heap_before = SystemMonitor::GetHeapInUseBytes();
     try {
         session_ = std::make_unique<Ort::Session>(env_, model_path.c_str(), session_options);
     } catch (const Ort::Exception& e) {
         throw std::runtime_error("Failed to load model: " + std::string(e.what()));
     }
+    session_memory_bytes_ = SystemMonitor::GetHeapInUseBytes() - heap_before;
+
+    memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
 
     Ort::AllocatorWithDefaultOptions allocator;
 
@@ -88,15 +261,30 @@ void InferenceEngine::LoadModel(const std::string& model_path, int opt_level) {
 }
 
 std::vector<float> InferenceEngine::Run(const std::vector<float>& input_data) {
+    return RunWithOptions(input_data, Ort::RunOptions{nullptr});
+}
+
+std::vector<float> InferenceEngine::Run(const std::vector<float>& input_data, CancelToken& cancel) {
+    Ort::RunOptions run_options;
+    cancel.SetHook([&run_options]() { run_options.SetTerminate(); });
+    try {
+        std::vector<float> output = RunWithOptions(input_data, run_options);
+        cancel.ClearHook();
+        return output;
+    } catch (...) {
+        cancel.ClearHook();
+        throw;
+    }
+}
+
+std::vector<float> InferenceEngine::RunWithOptions(const std::vector<float>& input_data, const Ort::RunOptions& run_options) {
     if (input_data.size() != input_tensor_size_) {
         throw std::runtime_error("Input data size mismatch!");
     }
 
-    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-
     // Zero-Copy 创建 input tensor
     Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-        memory_info, 
+        memory_info_, 
         const_cast<float*>(input_data.data()), 
         input_data.size(), 
         input_node_dims_.data(), 
@@ -104,7 +292,7 @@ std::vector<float> InferenceEngine::Run(const std::vector<float>& input_data) {
     );
 
     auto output_tensors = session_->Run(
-        Ort::RunOptions{nullptr}, 
+        run_options, 
         input_node_names_.data(), 
         &input_tensor, 
         1,
@@ -122,3 +310,10 @@ std::vector<float> InferenceEngine::Run(const std::vector<float>& input_data) {
 int64_t InferenceEngine::GetInputSize() const {
     return static_cast<int64_t>(input_tensor_size_);
 }
+
+AllocatorStats InferenceEngine::GetAllocatorStats() const {
+    if (allocator_mode_ != AllocatorMode::kTracking) {
+        return AllocatorStats();
+    }
+    return GetTrackingAllocator().GetStats();
+}
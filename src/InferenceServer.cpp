@@ -0,0 +1,531 @@
+#include "InferenceServer.h"
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// 解析后的端点
+struct Endpoint {
+    bool is_unix = false;
+    std::string host;
+    int port = 0;
+    std::string path;
+};
+
+Endpoint ParseEndpoint(const std::string& spec) {
+    Endpoint ep;
+    if (spec.compare(0, 5, "unix:") == 0) {
+        ep.is_unix = true;
+        ep.path = spec.substr(5);
+        if (ep.path.empty() || ep.path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::runtime_error("Invalid unix socket path: " + spec);
+        }
+        return ep;
+    }
+    if (spec.compare(0, 4, "tcp:") == 0) {
+        size_t colon = spec.rfind(':');
+        if (colon <= 4) {
+            throw std::runtime_error("Invalid tcp endpoint (expected tcp:<host>:<port>): " + spec);
+        }
+        ep.host = spec.substr(4, colon - 4);
+        if (ep.host == "localhost") ep.host = "127.0.0.1";
+        try {
+            ep.port = std::stoi(spec.substr(colon + 1));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Invalid tcp port: " + spec);
+        }
+        return ep;
+    }
+    throw std::runtime_error("Unknown endpoint (expected tcp:<host>:<port> or unix:<path>): " + spec);
+}
+
+// 构造 sockaddr，返回实际长度
+socklen_t MakeAddress(const Endpoint& ep, sockaddr_storage& storage) {
+    std::memset(&storage, 0, sizeof(storage));
+    if (ep.is_unix) {
+        auto* addr = reinterpret_cast<sockaddr_un*>(&storage);
+        addr->sun_family = AF_UNIX;
+        std::strncpy(addr->sun_path, ep.path.c_str(), sizeof(addr->sun_path) - 1);
+        return sizeof(sockaddr_un);
+    }
+    auto* addr = reinterpret_cast<sockaddr_in*>(&storage);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(static_cast<uint16_t>(ep.port));
+    if (inet_pton(AF_INET, ep.host.c_str(), &addr->sin_addr) != 1) {
+        throw std::runtime_error("Invalid IPv4 address: " + ep.host);
+    }
+    return sizeof(sockaddr_in);
+}
+
+// 阻塞写出全部数据；非阻塞 socket 遇到 EAGAIN 时等待可写。
+// timeout_ms >= 0 时，连续 timeout_ms 毫秒没有写出任何字节即放弃；cancel 置位时也立即放弃。
+bool SendAll(int fd, const char* data, size_t size, int timeout_ms = -1,
+             const std::atomic<bool>* cancel = nullptr) {
+    constexpr int kPollSliceMs = 100; // 等待期间检查 cancel 的间隔
+    auto last_progress = std::chrono::steady_clock::now();
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n > 0) {
+            data += n;
+            size -= static_cast<size_t>(n);
+            last_progress = std::chrono::steady_clock::now();
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (cancel != nullptr && cancel->load(std::memory_order_relaxed)) return false;
+            int wait_ms = kPollSliceMs;
+            if (timeout_ms >= 0) {
+                auto stalled = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - last_progress).count();
+                if (stalled >= timeout_ms) return false;
+                wait_ms = static_cast<int>(std::min<int64_t>(wait_ms, timeout_ms - stalled));
+            }
+            pollfd pfd{fd, POLLOUT, 0};
+            poll(&pfd, 1, wait_ms);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 阻塞读满 size 字节
+bool RecvAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(fd, data, size, 0);
+        if (n > 0) {
+            data += n;
+            size -= static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t ElapsedNs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// InferenceServer
+// ---------------------------------------------------------------------------
+
+InferenceServer::Connection::~Connection() {
+    close(fd);
+}
+
+InferenceServer::InferenceServer(Engine& engine, int send_timeout_ms)
+    : engine_(engine), send_timeout_ms_(send_timeout_ms) {}
+
+InferenceServer::~InferenceServer() {
+    Stop();
+}
+
+void InferenceServer::Start(const std::string& endpoint, int workers) {
+    Endpoint ep = ParseEndpoint(endpoint);
+    sockaddr_storage storage;
+    socklen_t addr_len = MakeAddress(ep, storage);
+
+    listen_fd_ = socket(ep.is_unix ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(std::string("socket() failed: ") + strerror(errno));
+    }
+    if (ep.is_unix) {
+        unlink(ep.path.c_str()); // 清理上次异常退出遗留的 socket 文件
+        unix_path_ = ep.path;
+    } else {
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&storage), addr_len) != 0 ||
+        listen(listen_fd_, SOMAXCONN) != 0) {
+        std::string err = strerror(errno);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Failed to listen on " + endpoint + ": " + err);
+    }
+
+    // 端口 0 时回填实际分配的端口
+    endpoint_ = endpoint;
+    if (!ep.is_unix) {
+        sockaddr_in bound;
+        socklen_t len = sizeof(bound);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&bound), &len);
+        endpoint_ = "tcp:" + ep.host + ":" + std::to_string(ntohs(bound.sin_port));
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev);
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+    stopping_ = false;
+    io_thread_ = std::thread(&InferenceServer::IoLoop, this);
+    for (int i = 0; i < std::max(workers, 1); ++i) {
+        workers_.emplace_back(&InferenceServer::WorkerLoop, this);
+    }
+}
+
+void InferenceServer::Stop() {
+    if (!io_thread_.joinable()) return;
+
+    uint64_t one = 1;
+    ssize_t ret = write(wake_fd_, &one, sizeof(one));
+    (void)ret;
+    io_thread_.join();
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+        queue_.clear();
+    }
+    queue_cv_.notify_all();
+    for (auto& w : workers_) {
+        if (w.joinable()) w.join();
+    }
+    workers_.clear();
+
+    connections_.clear();
+    close(listen_fd_);
+    close(epoll_fd_);
+    close(wake_fd_);
+    listen_fd_ = epoll_fd_ = wake_fd_ = -1;
+    if (!unix_path_.empty()) {
+        unlink(unix_path_.c_str());
+        unix_path_.clear();
+    }
+}
+
+void InferenceServer::IoLoop() {
+    epoll_event events[64];
+    while (true) {
+        int n = epoll_wait(epoll_fd_, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                return; // Stop() 请求退出
+            }
+            if (fd == listen_fd_) {
+                Accept();
+                continue;
+            }
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) continue;
+            if (!ReadFrames(it->second)) {
+                CloseConnection(fd);
+            }
+        }
+    }
+}
+
+void InferenceServer::Accept() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN: 已经取完；其他错误 (如 EMFILE) 留给下一次 epoll 通知
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // unix socket 上会失败，忽略
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+        connections_[fd] = std::make_shared<Connection>(fd);
+    }
+}
+
+bool InferenceServer::ReadFrames(const std::shared_ptr<Connection>& conn) {
+    // 1. 读空 socket 缓冲区
+    char chunk[64 * 1024];
+    bool peer_closed = false;
+    while (true) {
+        ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            conn->read_buffer.insert(conn->read_buffer.end(), chunk, chunk + n);
+        } else if (n == 0) {
+            peer_closed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    // 2. 拆出所有完整的请求帧
+    auto received = std::chrono::steady_clock::now();
+    std::vector<Job> jobs;
+    size_t offset = 0;
+    std::vector<char>& buf = conn->read_buffer;
+    while (buf.size() - offset >= sizeof(ServingRequestHeader)) {
+        ServingRequestHeader header;
+        std::memcpy(&header, buf.data() + offset, sizeof(header));
+        if (header.magic != kServingRequestMagic || header.payload_bytes > kServingMaxPayloadBytes ||
+            header.payload_bytes % sizeof(float) != 0) {
+            return false; // 协议错误，断开连接
+        }
+        size_t frame_size = sizeof(header) + header.payload_bytes;
+        if (buf.size() - offset < frame_size) break;
+
+        Job job;
+        job.conn = conn;
+        job.request_id = header.request_id;
+        job.input.resize(header.payload_bytes / sizeof(float));
+        std::memcpy(job.input.data(), buf.data() + offset + sizeof(header), header.payload_bytes);
+        job.received = received;
+        jobs.push_back(std::move(job));
+        offset += frame_size;
+    }
+    buf.erase(buf.begin(), buf.begin() + offset);
+
+    if (!jobs.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            for (auto& job : jobs) queue_.push_back(std::move(job));
+        }
+        if (jobs.size() == 1) queue_cv_.notify_one();
+        else queue_cv_.notify_all();
+    }
+    return !peer_closed;
+}
+
+void InferenceServer::CloseConnection(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    connections_.erase(fd); // 仍有 Job 引用时，fd 在其完成后关闭
+}
+
+void InferenceServer::WorkerLoop() {
+    std::vector<char> response;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        auto dequeued = std::chrono::steady_clock::now();
+
+        ServingResponseHeader header{};
+        header.magic = kServingResponseMagic;
+        header.request_id = job.request_id;
+        header.queue_ns = ElapsedNs(job.received, dequeued);
+
+        std::vector<float> output;
+        try {
+            output = engine_.Run(job.input);
+        } catch (const std::exception&) {
+            header.status = 1;
+        }
+        auto inferred = std::chrono::steady_clock::now();
+        header.infer_ns = ElapsedNs(dequeued, inferred);
+
+        // 序列化响应 (计入服务端驻留时间)
+        header.payload_bytes = static_cast<uint32_t>(output.size() * sizeof(float));
+        response.resize(sizeof(header) + header.payload_bytes);
+        std::memcpy(response.data() + sizeof(header), output.data(), header.payload_bytes);
+        header.server_ns = ElapsedNs(job.received, std::chrono::steady_clock::now());
+        std::memcpy(response.data(), &header, sizeof(header));
+
+        std::lock_guard<std::mutex> lock(job.conn->write_mutex);
+        if (job.conn->broken) continue;
+        if (!SendAll(job.conn->fd, response.data(), response.size(), send_timeout_ms_, &stopping_)) {
+            // 写到一半的帧已无法恢复：shutdown 让 IO 线程收到 EOF 后关闭连接，排队中的响应直接丢弃
+            job.conn->broken = true;
+            shutdown(job.conn->fd, SHUT_RDWR);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// LoadClient
+// ---------------------------------------------------------------------------
+
+LoadClient::LoadClient(const std::string& endpoint) : endpoint_(endpoint) {}
+
+int LoadClient::Connect() const {
+    Endpoint ep = ParseEndpoint(endpoint_);
+    sockaddr_storage storage;
+    socklen_t addr_len = MakeAddress(ep, storage);
+
+    int fd = socket(ep.is_unix ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&storage), addr_len) != 0) {
+        std::string err = strerror(errno);
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("Failed to connect to " + endpoint_ + ": " + err);
+    }
+    if (!ep.is_unix) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+ServingResult LoadClient::Run(const BenchmarkConfig& config, int64_t input_size) {
+    ServingResult result;
+    const int connections = std::max(config.threads, 1);
+
+    // 1. 准备测试数据 (与 BenchmarkRunner 相同的随机输入)
+    std::vector<float> input_data(input_size);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (auto& val : input_data) val = dist(gen);
+
+    // 每个连接的统计，最后合并
+    struct ConnectionStats {
+        std::unique_ptr<LatencyHistogram> e2e = std::make_unique<LatencyHistogram>();
+        std::unique_ptr<LatencyHistogram> queue = std::make_unique<LatencyHistogram>();
+        std::unique_ptr<LatencyHistogram> infer = std::make_unique<LatencyHistogram>();
+        uint64_t network_ns = 0;
+        int failed = 0;
+    };
+    std::vector<ConnectionStats> stats(connections);
+    for (auto& s : stats) {
+        s.e2e->Reset();
+        s.queue->Reset();
+        s.infer->Reset();
+    }
+
+    // 2. 先建立全部连接 (失败直接抛出)，不计入压测时间
+    std::vector<int> fds;
+    try {
+        for (int c = 0; c < connections; ++c) fds.push_back(Connect());
+    } catch (...) {
+        for (int fd : fds) close(fd);
+        throw;
+    }
+
+    // 单次请求-响应；返回 false 表示连接异常
+    auto round_trip = [&](int fd, std::vector<char>& request, std::vector<char>& payload,
+                          uint64_t request_id, ServingResponseHeader& header) {
+        // 序列化 (计入端到端延迟)
+        ServingRequestHeader req{kServingRequestMagic,
+                                 static_cast<uint32_t>(input_data.size() * sizeof(float)), request_id};
+        std::memcpy(request.data(), &req, sizeof(req));
+        std::memcpy(request.data() + sizeof(req), input_data.data(), req.payload_bytes);
+
+        if (!SendAll(fd, request.data(), request.size())) return false;
+        if (!RecvAll(fd, reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (header.magic != kServingResponseMagic || header.request_id != request_id ||
+            header.payload_bytes > kServingMaxPayloadBytes) {
+            return false;
+        }
+        payload.resize(header.payload_bytes);
+        return RecvAll(fd, payload.data(), payload.size());
+    };
+
+    // 3. 预热 (第一个连接上串行执行)
+    {
+        std::vector<char> request(sizeof(ServingRequestHeader) + input_data.size() * sizeof(float));
+        std::vector<char> payload;
+        ServingResponseHeader header;
+        for (int i = 0; i < config.warmup_rounds; ++i) {
+            if (!round_trip(fds[0], request, payload, static_cast<uint64_t>(i), header)) {
+                for (int fd : fds) close(fd);
+                throw std::runtime_error("Warmup request failed on " + endpoint_);
+            }
+        }
+    }
+
+    // 4. 每个连接一个线程，闭环抢单
+    std::atomic<int> remaining_requests(config.requests);
+    std::vector<std::thread> threads;
+    auto start_time = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < connections; ++c) {
+        threads.emplace_back([&, c]() {
+            ConnectionStats& s = stats[c];
+            std::vector<char> request(sizeof(ServingRequestHeader) + input_data.size() * sizeof(float));
+            std::vector<char> payload;
+            while (true) {
+                int current_req_idx = remaining_requests.fetch_sub(1);
+                if (current_req_idx <= 0) break;
+
+                ServingResponseHeader header;
+                auto t1 = std::chrono::steady_clock::now();
+                bool ok = round_trip(fds[c], request, payload, static_cast<uint64_t>(current_req_idx), header);
+                auto t2 = std::chrono::steady_clock::now();
+
+                if (!ok) {
+                    s.failed++;
+                    break; // 连接已不可用
+                }
+                if (header.status != 0) {
+                    s.failed++;
+                    continue;
+                }
+                uint64_t e2e_ns = ElapsedNs(t1, t2);
+                s.e2e->Record(e2e_ns);
+                s.queue->Record(header.queue_ns);
+                s.infer->Record(header.infer_ns);
+                s.network_ns += e2e_ns > header.server_ns ? e2e_ns - header.server_ns : 0;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    double total_time_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    for (int fd : fds) close(fd);
+
+    // 5. 汇总
+    auto e2e = std::make_unique<LatencyHistogram>();
+    auto queue = std::make_unique<LatencyHistogram>();
+    auto infer = std::make_unique<LatencyHistogram>();
+    e2e->Reset();
+    queue->Reset();
+    infer->Reset();
+    uint64_t network_ns = 0;
+    for (const auto& s : stats) {
+        e2e->Merge(*s.e2e);
+        queue->Merge(*s.queue);
+        infer->Merge(*s.infer);
+        network_ns += s.network_ns;
+        result.failed_requests += s.failed;
+    }
+
+    result.completed_requests = static_cast<int>(e2e->total_count);
+    result.qps = total_time_sec > 0 ? result.completed_requests / total_time_sec : 0.0;
+    result.e2e_avg_ms = e2e->MeanMs();
+    result.e2e_p99_ms = e2e->PercentileMs(0.99);
+    result.queue_avg_ms = queue->MeanMs();
+    result.queue_p99_ms = queue->PercentileMs(0.99);
+    result.infer_avg_ms = infer->MeanMs();
+    result.infer_p99_ms = infer->PercentileMs(0.99);
+    if (result.completed_requests > 0) {
+        result.network_avg_ms = static_cast<double>(network_ns) / result.completed_requests / 1e6;
+    }
+    return result;
+}
@@ -0,0 +1,66 @@
+#include "LatencyHistogram.h"
+#include <cstring>
+
+void LatencyHistogram::Reset() {
+    std::memset(counts, 0, sizeof(counts));
+    total_count = 0;
+    sum_ns = 0;
+    min_ns = UINT64_MAX;
+    max_ns = 0;
+}
+
+int LatencyHistogram::BucketIndex(uint64_t value_ns) {
+    // [0, 64) 逐纳秒一个桶
+    if (value_ns < static_cast<uint64_t>(kSubBucketCount)) {
+        return static_cast<int>(value_ns);
+    }
+    int msb = 63 - __builtin_clzll(value_ns);
+    if (msb > kMaxExponent) {
+        return kBucketCount - 1; // 超出范围的样本计入最后一个桶
+    }
+    // [2^msb, 2^(msb+1)) 线性划分为 64 个子桶
+    int shift = msb - kSubBucketBits;
+    int level = shift + 1;
+    int sub = static_cast<int>(value_ns >> shift) - kSubBucketCount;
+    return level * kSubBucketCount + sub;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(int index) {
+    int level = index / kSubBucketCount;
+    uint64_t sub = static_cast<uint64_t>(index % kSubBucketCount);
+    if (level == 0) return sub;
+    return (static_cast<uint64_t>(kSubBucketCount) + sub) << (level - 1);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBucketCount; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total_count += other.total_count;
+    sum_ns += other.sum_ns;
+    if (other.min_ns < min_ns) min_ns = other.min_ns;
+    if (other.max_ns > max_ns) max_ns = other.max_ns;
+}
+
+double LatencyHistogram::PercentileMs(double percentile) const {
+    if (total_count == 0) return 0.0;
+
+    // 与 BenchmarkRunner::CalculatePercentile 保持一致：取排序后第 p * N 个样本
+    uint64_t rank = static_cast<uint64_t>(percentile * total_count);
+    if (rank >= total_count) rank = total_count - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen > rank) {
+            uint64_t lower = BucketLowerBound(i);
+            uint64_t width = i < kSubBucketCount ? 1 : (1ull << (i / kSubBucketCount - 1));
+            double mid = lower + (width - 1) / 2.0;
+            // 桶中点不会超出实际观测范围
+            if (mid > max_ns) mid = static_cast<double>(max_ns);
+            if (mid < min_ns) mid = static_cast<double>(min_ns);
+            return mid / 1e6;
+        }
+    }
+    return max_ns / 1e6;
+}
@@ -0,0 +1,888 @@
+#include "ModelAnalyzer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// protobuf wire format 读取器 (只读，零拷贝)
+// ---------------------------------------------------------------------------
+
+class ProtoReader {
+public:
+    ProtoReader(const char* data, size_t size)
+        : pos_(reinterpret_cast<const uint8_t*>(data)), end_(pos_ + size) {}
+
+    /// 读取下一个字段的 tag，到达末尾时返回 false
+    bool Next() {
+        if (pos_ >= end_) return false;
+        uint64_t tag = ReadVarint();
+        field_ = static_cast<uint32_t>(tag >> 3);
+        wire_type_ = static_cast<int>(tag & 7);
+        return true;
+    }
+
+    uint32_t field() const { return field_; }
+
+    uint64_t ReadVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= end_) Fail();
+            uint8_t byte = *pos_++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        Fail();
+    }
+
+    float ReadFloat() {
+        if (end_ - pos_ < 4) Fail();
+        float value;
+        std::memcpy(&value, pos_, sizeof(value));
+        pos_ += 4;
+        return value;
+    }
+
+    ProtoReader ReadMessage() {
+        uint64_t len = ReadVarint();
+        if (len > static_cast<uint64_t>(end_ - pos_)) Fail();
+        ProtoReader sub(reinterpret_cast<const char*>(pos_), len);
+        pos_ += len;
+        return sub;
+    }
+
+    std::string ReadString() {
+        ProtoReader sub = ReadMessage();
+        return std::string(reinterpret_cast<const char*>(sub.pos_), sub.end_ - sub.pos_);
+    }
+
+    /// repeated int64/int32：兼容 packed 与非 packed 两种编码
+    void ReadInts(std::vector<int64_t>& out) {
+        if (wire_type_ == 2) {
+            ProtoReader packed = ReadMessage();
+            while (packed.pos_ < packed.end_) out.push_back(static_cast<int64_t>(packed.ReadVarint()));
+        } else {
+            out.push_back(static_cast<int64_t>(ReadVarint()));
+        }
+    }
+
+    /// 跳过当前字段
+    void Skip() {
+        switch (wire_type_) {
+            case 0: ReadVarint(); break;
+            case 1: Advance(8); break;
+            case 2: ReadMessage(); break;
+            case 5: Advance(4); break;
+            default: Fail(); // ONNX 不使用 group 编码
+        }
+    }
+
+private:
+    [[noreturn]] static void Fail() {
+        throw std::runtime_error("Malformed ONNX model (protobuf decode error)");
+    }
+
+    void Advance(size_t n) {
+        if (static_cast<size_t>(end_ - pos_) < n) Fail();
+        pos_ += n;
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    uint32_t field_ = 0;
+    int wire_type_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// ONNX 结构 (只保留分析需要的字段)
+// ---------------------------------------------------------------------------
+
+// TensorProto.DataType
+constexpr int32_t kFloat = 1;
+constexpr int32_t kInt32 = 6;
+constexpr int32_t kInt64 = 7;
+
+// 只保留不超过该元素数的整型常量 (形状向量、索引等)
+constexpr int64_t kMaxConstValues = 64;
+
+int64_t ElementSize(int32_t elem_type) {
+    switch (elem_type) {
+        case 2: case 3: case 9: return 1;           // UINT8, INT8, BOOL
+        case 4: case 5: case 10: case 16: return 2; // UINT16, INT16, FLOAT16, BFLOAT16
+        case 7: case 11: case 13: return 8;         // INT64, DOUBLE, UINT64
+        default: return 4;                          // FLOAT, INT32, UINT32, ...
+    }
+}
+
+struct TensorInfo {
+    std::vector<int64_t> dims;
+    int32_t elem_type = kFloat;
+    bool known = false;            // 形状是否已知
+    bool has_values = false;       // values 是否有效
+    std::vector<int64_t> values;   // 小的整型常量
+
+    int64_t Elements() const {
+        int64_t n = 1;
+        for (int64_t d : dims) n *= d;
+        return n;
+    }
+    int64_t Bytes() const { return known ? Elements() * ElementSize(elem_type) : 0; }
+};
+
+struct Attribute {
+    int64_t i = 0;
+    float f = 0.0f;
+    std::string s;
+    std::vector<int64_t> ints;
+    bool has_t = false;
+    TensorInfo t;
+};
+
+struct Node {
+    std::string op_type;
+    std::string domain;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    std::map<std::string, Attribute> attributes;
+
+    int64_t GetInt(const std::string& name, int64_t def) const {
+        auto it = attributes.find(name);
+        return it != attributes.end() ? it->second.i : def;
+    }
+    std::vector<int64_t> GetInts(const std::string& name) const {
+        auto it = attributes.find(name);
+        return it != attributes.end() ? it->second.ints : std::vector<int64_t>();
+    }
+    std::string GetString(const std::string& name, const std::string& def) const {
+        auto it = attributes.find(name);
+        return it != attributes.end() ? it->second.s : def;
+    }
+    bool Has(const std::string& name) const { return attributes.count(name) > 0; }
+};
+
+struct Graph {
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, TensorInfo> tensors;
+    std::set<std::string> initializers;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+};
+
+TensorInfo ParseTensor(ProtoReader r, std::string* name) {
+    TensorInfo info;
+    info.known = true;
+    std::vector<int64_t> int_data;
+    std::string raw;
+    while (r.Next()) {
+        switch (r.field()) {
+            case 1: r.ReadInts(info.dims); break;
+            case 2: info.elem_type = static_cast<int32_t>(r.ReadVarint()); break;
+            case 5: case 7: r.ReadInts(int_data); break; // int32_data / int64_data
+            case 8: if (name) *name = r.ReadString(); else r.Skip(); break;
+            case 9: raw = r.ReadString(); break;
+            default: r.Skip(); break;
+        }
+    }
+
+    if (info.elem_type == kInt64 || info.elem_type == kInt32) {
+        int64_t count = info.Elements();
+        if (count <= kMaxConstValues) {
+            if (!raw.empty()) {
+                size_t width = info.elem_type == kInt64 ? 8 : 4;
+                for (size_t off = 0; off + width <= raw.size(); off += width) {
+                    if (width == 8) {
+                        int64_t v;
+                        std::memcpy(&v, raw.data() + off, 8);
+                        info.values.push_back(v);
+                    } else {
+                        int32_t v;
+                        std::memcpy(&v, raw.data() + off, 4);
+                        info.values.push_back(v);
+                    }
+                }
+            } else {
+                info.values = int_data;
+            }
+            info.has_values = static_cast<int64_t>(info.values.size()) == count;
+        }
+    }
+    return info;
+}
+
+void ParseValueInfo(ProtoReader r, std::string& name, TensorInfo& info) {
+    while (r.Next()) {
+        if (r.field() == 1) {
+            name = r.ReadString();
+        } else if (r.field() == 2) {
+            ProtoReader type = r.ReadMessage();
+            while (type.Next()) {
+                if (type.field() != 1) { type.Skip(); continue; } // tensor_type
+                ProtoReader tensor = type.ReadMessage();
+                while (tensor.Next()) {
+                    if (tensor.field() == 1) {
+                        info.elem_type = static_cast<int32_t>(tensor.ReadVarint());
+                    } else if (tensor.field() == 2) {
+                        info.known = true;
+                        ProtoReader shape = tensor.ReadMessage();
+                        while (shape.Next()) {
+                            if (shape.field() != 1) { shape.Skip(); continue; }
+                            ProtoReader dim = shape.ReadMessage();
+                            int64_t value = 1; // dim_param (动态维度) 按 1 计算
+                            while (dim.Next()) {
+                                if (dim.field() == 1) value = std::max<int64_t>(static_cast<int64_t>(dim.ReadVarint()), 1);
+                                else dim.Skip();
+                            }
+                            info.dims.push_back(value);
+                        }
+                    } else {
+                        tensor.Skip();
+                    }
+                }
+            }
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+Node ParseNode(ProtoReader r) {
+    Node node;
+    while (r.Next()) {
+        switch (r.field()) {
+            case 1: node.inputs.push_back(r.ReadString()); break;
+            case 2: node.outputs.push_back(r.ReadString()); break;
+            case 4: node.op_type = r.ReadString(); break;
+            case 7: node.domain = r.ReadString(); break;
+            case 5: {
+                ProtoReader a = r.ReadMessage();
+                std::string attr_name;
+                Attribute attr;
+                while (a.Next()) {
+                    switch (a.field()) {
+                        case 1: attr_name = a.ReadString(); break;
+                        case 2: attr.f = a.ReadFloat(); break;
+                        case 3: attr.i = static_cast<int64_t>(a.ReadVarint()); break;
+                        case 4: attr.s = a.ReadString(); break;
+                        case 5: attr.t = ParseTensor(a.ReadMessage(), nullptr); attr.has_t = true; break;
+                        case 8: a.ReadInts(attr.ints); break;
+                        default: a.Skip(); break;
+                    }
+                }
+                node.attributes[attr_name] = std::move(attr);
+                break;
+            }
+            default: r.Skip(); break;
+        }
+    }
+    return node;
+}
+
+Graph ParseModel(const std::string& data) {
+    ProtoReader model(data.data(), data.size());
+    bool has_graph = false;
+    Graph graph;
+    std::vector<std::pair<std::string, TensorInfo>> value_infos;
+
+    while (model.Next()) {
+        if (model.field() != 7) { model.Skip(); continue; } // ModelProto.graph
+        has_graph = true;
+        ProtoReader g = model.ReadMessage();
+        while (g.Next()) {
+            switch (g.field()) {
+                case 1: graph.nodes.push_back(ParseNode(g.ReadMessage())); break;
+                case 5: {
+                    std::string name;
+                    TensorInfo info = ParseTensor(g.ReadMessage(), &name);
+                    graph.initializers.insert(name);
+                    graph.tensors[name] = std::move(info);
+                    break;
+                }
+                case 11: case 12: case 13: {
+                    uint32_t field = g.field();
+                    std::string name;
+                    TensorInfo info;
+                    ParseValueInfo(g.ReadMessage(), name, info);
+                    if (field == 11) graph.inputs.push_back(name);
+                    if (field == 12) graph.outputs.push_back(name);
+                    value_infos.emplace_back(name, std::move(info));
+                    break;
+                }
+                default: g.Skip(); break;
+            }
+        }
+    }
+    if (!has_graph) {
+        throw std::runtime_error("Invalid ONNX model: no graph found");
+    }
+
+    // 旧版 opset 会把 initializer 也列在 graph.input 中
+    graph.inputs.erase(std::remove_if(graph.inputs.begin(), graph.inputs.end(),
+                                      [&](const std::string& n) { return graph.initializers.count(n) > 0; }),
+                       graph.inputs.end());
+    for (auto& vi : value_infos) {
+        if (!graph.initializers.count(vi.first) && vi.second.known) {
+            graph.tensors[vi.first] = std::move(vi.second);
+        }
+    }
+    return graph;
+}
+
+// ---------------------------------------------------------------------------
+// 形状推导
+// ---------------------------------------------------------------------------
+
+std::vector<int64_t> Broadcast(const std::vector<int64_t>& a, const std::vector<int64_t>& b) {
+    std::vector<int64_t> out(std::max(a.size(), b.size()), 1);
+    for (size_t i = 0; i < out.size(); ++i) {
+        int64_t da = i < a.size() ? a[a.size() - 1 - i] : 1;
+        int64_t db = i < b.size() ? b[b.size() - 1 - i] : 1;
+        out[out.size() - 1 - i] = std::max(da, db);
+    }
+    return out;
+}
+
+int64_t NormalizeAxis(int64_t axis, size_t rank) {
+    return axis < 0 ? axis + static_cast<int64_t>(rank) : axis;
+}
+
+// Conv / Pool 的空间维度输出
+bool SpatialOutput(const Node& node, const std::vector<int64_t>& in, const std::vector<int64_t>& kernel,
+                   std::vector<int64_t>& out_spatial) {
+    size_t n = kernel.size();
+    if (in.size() != n + 2) return false;
+    std::vector<int64_t> strides = node.GetInts("strides");
+    std::vector<int64_t> dilations = node.GetInts("dilations");
+    std::vector<int64_t> pads = node.GetInts("pads");
+    std::string auto_pad = node.GetString("auto_pad", "NOTSET");
+    bool ceil_mode = node.GetInt("ceil_mode", 0) != 0;
+    strides.resize(n, 1);
+    dilations.resize(n, 1);
+    pads.resize(2 * n, 0);
+
+    out_spatial.clear();
+    for (size_t i = 0; i < n; ++i) {
+        int64_t size = in[i + 2];
+        int64_t stride = std::max<int64_t>(strides[i], 1);
+        if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+            out_spatial.push_back((size + stride - 1) / stride);
+            continue;
+        }
+        int64_t pad = auto_pad == "VALID" ? 0 : pads[i] + pads[i + n];
+        int64_t effective = dilations[i] * (kernel[i] - 1) + 1;
+        int64_t span = size + pad - effective;
+        if (span < 0) return false;
+        out_spatial.push_back((ceil_mode ? (span + stride - 1) / stride : span / stride) + 1);
+    }
+    return true;
+}
+
+class ShapeInference {
+public:
+    explicit ShapeInference(Graph& graph) : graph_(graph) {}
+
+    const TensorInfo* Get(const std::string& name) const {
+        auto it = graph_.tensors.find(name);
+        return it != graph_.tensors.end() && it->second.known ? &it->second : nullptr;
+    }
+
+    /// 推导节点第一个输出的形状 (value_info 已提供时不覆盖)
+    void Infer(const Node& node) {
+        if (node.outputs.empty() || node.outputs[0].empty()) return;
+        TensorInfo* existing = Find(node.outputs[0]);
+        TensorInfo out;
+        if (!InferOutput(node, out)) return;
+        if (existing && existing->known) {
+            // 保留 value_info 中的形状，只补充常量值
+            if (out.has_values && !existing->has_values) {
+                existing->values = out.values;
+                existing->has_values = true;
+            }
+            return;
+        }
+        out.known = true;
+        graph_.tensors[node.outputs[0]] = std::move(out);
+    }
+
+private:
+    TensorInfo* Find(const std::string& name) {
+        auto it = graph_.tensors.find(name);
+        return it != graph_.tensors.end() ? &it->second : nullptr;
+    }
+
+    const TensorInfo* Input(const Node& node, size_t i) const {
+        return i < node.inputs.size() && !node.inputs[i].empty() ? Get(node.inputs[i]) : nullptr;
+    }
+
+    bool InferOutput(const Node& node, TensorInfo& out) const {
+        const std::string& op = node.op_type;
+        const TensorInfo* x = Input(node, 0);
+
+        if (op == "Constant") {
+            auto it = node.attributes.find("value");
+            if (it == node.attributes.end() || !it->second.has_t) return false;
+            out = it->second.t;
+            return true;
+        }
+        if (!x) return false;
+        out.elem_type = x->elem_type;
+
+        // 逐元素 / 保持形状的算子
+        static const std::set<std::string> kSameShape = {
+            "Relu", "LeakyRelu", "PRelu", "Sigmoid", "Tanh", "Clip", "Erf", "Sqrt", "Exp", "Log", "Neg",
+            "Abs", "Reciprocal", "Softplus", "HardSigmoid", "HardSwish", "Gelu", "FastGelu", "BiasGelu",
+            "Dropout", "Identity", "BatchNormalization", "InstanceNormalization", "LayerNormalization",
+            "SimplifiedLayerNormalization", "SkipLayerNormalization", "GroupNormalization", "LRN",
+            "Softmax", "LogSoftmax", "Not", "Floor", "Ceil", "Round", "Sign", "Mish", "Elu", "Selu", "Cast"};
+        if (kSameShape.count(op)) {
+            out.dims = x->dims;
+            if (op == "Cast") {
+                out.elem_type = static_cast<int32_t>(node.GetInt("to", x->elem_type));
+                out.values = x->values;
+                out.has_values = x->has_values;
+            }
+            return true;
+        }
+
+        static const std::set<std::string> kBroadcast = {
+            "Add", "Sub", "Mul", "Div", "Pow", "Max", "Min", "Sum", "Mean", "Where",
+            "Equal", "Greater", "Less", "GreaterOrEqual", "LessOrEqual", "And", "Or", "Xor", "Mod"};
+        if (kBroadcast.count(op)) {
+            out.dims = x->dims;
+            for (size_t i = 1; i < node.inputs.size(); ++i) {
+                const TensorInfo* other = Input(node, i);
+                if (!other) return false;
+                out.dims = Broadcast(out.dims, other->dims);
+            }
+            if (op == "Where") out.elem_type = Input(node, 1)->elem_type;
+            static const std::set<std::string> kBoolOutput = {
+                "Equal", "Greater", "Less", "GreaterOrEqual", "LessOrEqual", "And", "Or", "Xor"};
+            if (kBoolOutput.count(op)) out.elem_type = 9;
+            return true;
+        }
+
+        if (op == "Conv") {
+            const TensorInfo* w = Input(node, 1);
+            if (!w || w->dims.size() < 3) return false;
+            std::vector<int64_t> kernel = node.GetInts("kernel_shape");
+            if (kernel.empty()) kernel.assign(w->dims.begin() + 2, w->dims.end());
+            std::vector<int64_t> spatial;
+            if (!SpatialOutput(node, x->dims, kernel, spatial)) return false;
+            out.dims = {x->dims[0], w->dims[0]};
+            out.dims.insert(out.dims.end(), spatial.begin(), spatial.end());
+            return true;
+        }
+        if (op == "ConvTranspose") {
+            const TensorInfo* w = Input(node, 1);
+            if (!w || w->dims.size() < 3 || x->dims.size() != w->dims.size()) return false;
+            std::vector<int64_t> explicit_shape = node.GetInts("output_shape");
+            size_t n = w->dims.size() - 2;
+            std::vector<int64_t> strides = node.GetInts("strides");
+            std::vector<int64_t> pads = node.GetInts("pads");
+            std::vector<int64_t> dilations = node.GetInts("dilations");
+            std::vector<int64_t> output_padding = node.GetInts("output_padding");
+            strides.resize(n, 1);
+            pads.resize(2 * n, 0);
+            dilations.resize(n, 1);
+            output_padding.resize(n, 0);
+            out.dims = {x->dims[0], w->dims[1] * node.GetInt("group", 1)};
+            for (size_t i = 0; i < n; ++i) {
+                if (explicit_shape.size() == n) {
+                    out.dims.push_back(explicit_shape[i]);
+                } else {
+                    out.dims.push_back(strides[i] * (x->dims[i + 2] - 1) + output_padding[i] +
+                                       (w->dims[i + 2] - 1) * dilations[i] + 1 - pads[i] - pads[i + n]);
+                }
+            }
+            return true;
+        }
+        if (op == "MaxPool" || op == "AveragePool" || op == "LpPool") {
+            std::vector<int64_t> spatial;
+            if (!SpatialOutput(node, x->dims, node.GetInts("kernel_shape"), spatial)) return false;
+            out.dims = {x->dims[0], x->dims[1]};
+            out.dims.insert(out.dims.end(), spatial.begin(), spatial.end());
+            return true;
+        }
+        if (op == "GlobalAveragePool" || op == "GlobalMaxPool") {
+            if (x->dims.size() < 3) return false;
+            out.dims = x->dims;
+            std::fill(out.dims.begin() + 2, out.dims.end(), 1);
+            return true;
+        }
+        if (op == "Gemm") {
+            const TensorInfo* b = Input(node, 1);
+            if (!b || x->dims.size() != 2 || b->dims.size() != 2) return false;
+            int64_t m = node.GetInt("transA", 0) ? x->dims[1] : x->dims[0];
+            int64_t n = node.GetInt("transB", 0) ? b->dims[0] : b->dims[1];
+            out.dims = {m, n};
+            return true;
+        }
+        if (op == "MatMul" || op == "MatMulInteger" || op == "FusedMatMul") {
+            const TensorInfo* b = Input(node, 1);
+            if (!b || x->dims.empty() || b->dims.empty()) return false;
+            std::vector<int64_t> a_dims = x->dims, b_dims = b->dims;
+            if (a_dims.size() == 1) a_dims.insert(a_dims.begin(), 1);
+            if (b_dims.size() == 1) b_dims.push_back(1);
+            std::vector<int64_t> batch = Broadcast(std::vector<int64_t>(a_dims.begin(), a_dims.end() - 2),
+                                                   std::vector<int64_t>(b_dims.begin(), b_dims.end() - 2));
+            out.dims = batch;
+            if (x->dims.size() > 1) out.dims.push_back(a_dims[a_dims.size() - 2]);
+            if (b->dims.size() > 1) out.dims.push_back(b_dims.back());
+            if (op == "MatMulInteger") out.elem_type = kInt32;
+            return true;
+        }
+        if (op == "Flatten") {
+            int64_t axis = NormalizeAxis(node.GetInt("axis", 1), x->dims.size());
+            int64_t outer = 1, inner = 1;
+            for (size_t i = 0; i < x->dims.size(); ++i) {
+                (static_cast<int64_t>(i) < axis ? outer : inner) *= x->dims[i];
+            }
+            out.dims = {outer, inner};
+            return true;
+        }
+        if (op == "Reshape") {
+            const TensorInfo* shape = Input(node, 1);
+            if (!shape || !shape->has_values) return false;
+            int64_t known = 1;
+            int infer_axis = -1;
+            for (size_t i = 0; i < shape->values.size(); ++i) {
+                int64_t d = shape->values[i];
+                if (d == 0 && i < x->dims.size()) d = x->dims[i];
+                if (d == -1) {
+                    infer_axis = static_cast<int>(i);
+                    d = 1;
+                }
+                out.dims.push_back(d);
+                known *= d;
+            }
+            if (infer_axis >= 0) out.dims[infer_axis] = known > 0 ? x->Elements() / known : 0;
+            out.values = x->values;
+            out.has_values = x->has_values;
+            return true;
+        }
+        if (op == "Transpose") {
+            std::vector<int64_t> perm = node.GetInts("perm");
+            if (perm.empty()) {
+                for (size_t i = x->dims.size(); i > 0; --i) perm.push_back(static_cast<int64_t>(i - 1));
+            }
+            if (perm.size() != x->dims.size()) return false;
+            for (int64_t p : perm) out.dims.push_back(x->dims[p]);
+            return true;
+        }
+        if (op == "Concat") {
+            int64_t axis = NormalizeAxis(node.GetInt("axis", 0), x->dims.size());
+            if (axis < 0 || axis >= static_cast<int64_t>(x->dims.size())) return false;
+            out.dims = x->dims;
+            out.dims[axis] = 0;
+            out.has_values = true;
+            for (size_t i = 0; i < node.inputs.size(); ++i) {
+                const TensorInfo* in = Input(node, i);
+                if (!in || in->dims.size() != x->dims.size()) return false;
+                out.dims[axis] += in->dims[axis];
+                out.has_values = out.has_values && in->has_values;
+                if (in->has_values) out.values.insert(out.values.end(), in->values.begin(), in->values.end());
+            }
+            if (!out.has_values || x->dims.size() != 1) {
+                out.has_values = false;
+                out.values.clear();
+            }
+            return true;
+        }
+        if (op == "Squeeze" || op == "Unsqueeze") {
+            std::vector<int64_t> axes = node.GetInts("axes");
+            const TensorInfo* axes_input = Input(node, 1); // opset 13+ 以输入给出
+            if (axes.empty() && axes_input && axes_input->has_values) axes = axes_input->values;
+            if (op == "Unsqueeze") {
+                if (axes.empty()) return false;
+                size_t rank = x->dims.size() + axes.size();
+                std::set<int64_t> axis_set;
+                for (int64_t a : axes) axis_set.insert(NormalizeAxis(a, rank));
+                size_t src = 0;
+                for (size_t i = 0; i < rank; ++i) {
+                    if (axis_set.count(static_cast<int64_t>(i))) out.dims.push_back(1);
+                    else if (src < x->dims.size()) out.dims.push_back(x->dims[src++]);
+                    else return false;
+                }
+            } else {
+                std::set<int64_t> axis_set;
+                for (int64_t a : axes) axis_set.insert(NormalizeAxis(a, x->dims.size()));
+                for (size_t i = 0; i < x->dims.size(); ++i) {
+                    bool squeeze = axes.empty() ? x->dims[i] == 1 : axis_set.count(static_cast<int64_t>(i)) > 0;
+                    if (!squeeze) out.dims.push_back(x->dims[i]);
+                }
+            }
+            out.values = x->values;
+            out.has_values = x->has_values;
+            return true;
+        }
+        if (op == "Shape") {
+            out.elem_type = kInt64;
+            out.dims = {static_cast<int64_t>(x->dims.size())};
+            out.values = x->dims;
+            out.has_values = true;
+            return true;
+        }
+        if (op == "Gather") {
+            const TensorInfo* indices = Input(node, 1);
+            if (!indices) return false;
+            int64_t axis = NormalizeAxis(node.GetInt("axis", 0), x->dims.size());
+            if (axis < 0 || axis >= static_cast<int64_t>(x->dims.size())) return false;
+            out.dims.assign(x->dims.begin(), x->dims.begin() + axis);
+            out.dims.insert(out.dims.end(), indices->dims.begin(), indices->dims.end());
+            out.dims.insert(out.dims.end(), x->dims.begin() + axis + 1, x->dims.end());
+            // 常量折叠：Shape -> Gather 取单个维度
+            if (x->has_values && indices->has_values && x->dims.size() == 1) {
+                for (int64_t idx : indices->values) {
+                    idx = NormalizeAxis(idx, x->values.size());
+                    if (idx < 0 || idx >= static_cast<int64_t>(x->values.size())) return true;
+                    out.values.push_back(x->values[idx]);
+                }
+                out.has_values = true;
+            }
+            return true;
+        }
+        if (op == "ReduceMean" || op == "ReduceSum" || op == "ReduceMax" || op == "ReduceMin") {
+            std::vector<int64_t> axes = node.GetInts("axes");
+            const TensorInfo* axes_input = Input(node, 1);
+            if (axes.empty() && axes_input && axes_input->has_values) axes = axes_input->values;
+            bool keepdims = node.GetInt("keepdims", 1) != 0;
+            std::set<int64_t> axis_set;
+            for (int64_t a : axes) axis_set.insert(NormalizeAxis(a, x->dims.size()));
+            for (size_t i = 0; i < x->dims.size(); ++i) {
+                bool reduced = axes.empty() || axis_set.count(static_cast<int64_t>(i));
+                if (!reduced) out.dims.push_back(x->dims[i]);
+                else if (keepdims) out.dims.push_back(1);
+            }
+            return true;
+        }
+        if (node.domain == "com.microsoft" && (op == "Attention" || op == "MultiHeadAttention")) {
+            if (x->dims.size() != 3) return false;
+            int64_t hidden = x->dims[2];
+            if (op == "Attention") {
+                const TensorInfo* w = Input(node, 1);
+                if (!w || w->dims.size() != 2) return false;
+                hidden = w->dims[1] / 3;
+            }
+            out.dims = {x->dims[0], x->dims[1], hidden};
+            return true;
+        }
+        return false;
+    }
+
+    Graph& graph_;
+};
+
+// ---------------------------------------------------------------------------
+// FLOPs 估计
+// ---------------------------------------------------------------------------
+
+/// 返回 false 表示算子不支持 (不计入 FLOPs)
+bool EstimateFlops(const Node& node, const ShapeInference& shapes, double& flops) {
+    const std::string& op = node.op_type;
+    auto in = [&](size_t i) {
+        return i < node.inputs.size() && !node.inputs[i].empty() ? shapes.Get(node.inputs[i]) : nullptr;
+    };
+    const TensorInfo* x = in(0);
+    const TensorInfo* y = node.outputs.empty() ? nullptr : shapes.Get(node.outputs[0]);
+    flops = 0.0;
+
+    static const std::set<std::string> kDataMovement = {
+        "Reshape", "Flatten", "Transpose", "Concat", "Split", "Slice", "Gather", "GatherElements",
+        "Squeeze", "Unsqueeze", "Identity", "Dropout", "Cast", "Shape", "Constant", "ConstantOfShape",
+        "Pad", "Expand", "Tile", "Resize", "Upsample", "DepthToSpace", "SpaceToDepth", "Range", "Size",
+        "QuantizeLinear", "DequantizeLinear"};
+    if (kDataMovement.count(op)) return true;
+    if (!y) return false;
+    double out_elems = static_cast<double>(y->Elements());
+
+    if (op == "Conv") {
+        const TensorInfo* w = in(1);
+        if (!w) return false;
+        double per_output = 1.0;
+        for (size_t i = 1; i < w->dims.size(); ++i) per_output *= w->dims[i];
+        flops = 2.0 * out_elems * per_output + (in(2) ? out_elems : 0.0);
+        return true;
+    }
+    if (op == "ConvTranspose") {
+        const TensorInfo* w = in(1);
+        if (!w || !x) return false;
+        double per_input = 1.0;
+        for (size_t i = 1; i < w->dims.size(); ++i) per_input *= w->dims[i];
+        flops = 2.0 * x->Elements() * per_input + (in(2) ? out_elems : 0.0);
+        return true;
+    }
+    if (op == "Gemm") {
+        if (!x) return false;
+        double k = node.GetInt("transA", 0) ? x->dims[0] : x->dims.back();
+        flops = 2.0 * out_elems * k + (in(2) ? out_elems : 0.0);
+        return true;
+    }
+    if (op == "MatMul" || op == "MatMulInteger" || op == "FusedMatMul") {
+        if (!x) return false;
+        flops = 2.0 * out_elems * x->dims.back();
+        return true;
+    }
+    if (node.domain == "com.microsoft" && op == "Attention") {
+        const TensorInfo* w = in(1);
+        if (!x || !w || x->dims.size() != 3) return false;
+        double b = x->dims[0], s = x->dims[1], h_in = x->dims[2], h = w->dims[1] / 3.0;
+        double heads = static_cast<double>(node.GetInt("num_heads", 1));
+        // QKV 投影 + QK^T + Attn*V + Softmax
+        flops = 2.0 * b * s * h_in * 3.0 * h + 4.0 * b * s * s * h + 3.0 * b * heads * s * s;
+        return true;
+    }
+    if (node.domain == "com.microsoft" && op == "MultiHeadAttention") {
+        const TensorInfo* k = in(1);
+        if (!x || !k || x->dims.size() != 3 || k->dims.size() != 3) return false;
+        double b = x->dims[0], s = x->dims[1], h = x->dims[2], l = k->dims[1];
+        double heads = static_cast<double>(node.GetInt("num_heads", 1));
+        flops = 4.0 * b * s * l * h + 3.0 * b * heads * s * l;
+        return true;
+    }
+    if (op == "MaxPool" || op == "AveragePool" || op == "LpPool") {
+        double kernel = 1.0;
+        for (int64_t k : node.GetInts("kernel_shape")) kernel *= k;
+        flops = out_elems * kernel;
+        return true;
+    }
+    if (op == "GlobalAveragePool" || op == "GlobalMaxPool" || op.compare(0, 6, "Reduce") == 0) {
+        if (!x) return false;
+        flops = static_cast<double>(x->Elements());
+        return true;
+    }
+    if (op == "BatchNormalization") {
+        flops = 2.0 * out_elems;
+        return true;
+    }
+    if (op == "InstanceNormalization" || op == "LayerNormalization" || op == "SimplifiedLayerNormalization" ||
+        op == "SkipLayerNormalization" || op == "GroupNormalization" || op == "LRN") {
+        flops = 5.0 * out_elems;
+        return true;
+    }
+    if (op == "Softmax" || op == "LogSoftmax") {
+        flops = 3.0 * out_elems;
+        return true;
+    }
+
+    static const std::set<std::string> kElementwise = {
+        "Add", "Sub", "Mul", "Div", "Pow", "Max", "Min", "Sum", "Mean", "Where", "Relu", "LeakyRelu",
+        "PRelu", "Sigmoid", "Tanh", "Clip", "Erf", "Sqrt", "Exp", "Log", "Neg", "Abs", "Reciprocal",
+        "Softplus", "HardSigmoid", "HardSwish", "Gelu", "FastGelu", "BiasGelu", "Equal", "Greater", "Less",
+        "GreaterOrEqual", "LessOrEqual", "And", "Or", "Xor", "Not", "Mod", "Floor", "Ceil", "Round", "Sign",
+        "Mish", "Elu", "Selu"};
+    if (kElementwise.count(op)) {
+        flops = out_elems;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+ModelCost ModelAnalyzer::Analyze(const std::string& model_path) {
+    std::ifstream file(model_path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open model file: " + model_path);
+    }
+    // 按文件大小一次性读入预分配的缓冲区 (模型可接近 2GB，避免经 stringstream 再复制一份)
+    std::streamoff size = file.tellg();
+    if (size < 0) {
+        throw std::runtime_error("Failed to read model file: " + model_path);
+    }
+    std::string data(static_cast<size_t>(size), '\0');
+    file.seekg(0);
+    if (!file.read(&data[0], size)) {
+        throw std::runtime_error("Failed to read model file: " + model_path);
+    }
+    return AnalyzeBuffer(data);
+}
+
+ModelCost ModelAnalyzer::AnalyzeBuffer(const std::string& data) {
+    Graph graph = ParseModel(data);
+    ShapeInference shapes(graph);
+    ModelCost cost;
+
+    // 1. 参数
+    for (const auto& name : graph.initializers) {
+        const TensorInfo& t = graph.tensors[name];
+        cost.parameter_count += t.Elements();
+        cost.parameter_bytes += t.Bytes();
+    }
+
+    // 2. 逐节点 (ONNX 要求节点按拓扑序排列) 推导形状并估算 FLOPs / 访存
+    std::map<std::string, OpCost> by_op;
+    for (const Node& node : graph.nodes) {
+        shapes.Infer(node);
+
+        double flops = 0.0;
+        bool analyzed = EstimateFlops(node, shapes, flops);
+        double bytes = 0.0;
+        for (const auto& name : node.inputs) {
+            if (const TensorInfo* t = name.empty() ? nullptr : shapes.Get(name)) bytes += t->Bytes();
+        }
+        for (const auto& name : node.outputs) {
+            if (const TensorInfo* t = name.empty() ? nullptr : shapes.Get(name)) bytes += t->Bytes();
+            else analyzed = analyzed && name.empty();
+        }
+
+        std::string key = node.domain.empty() || node.domain == "ai.onnx" ? node.op_type
+                                                                           : node.domain + "." + node.op_type;
+        OpCost& op = by_op[key];
+        op.op_type = key;
+        op.count++;
+        op.flops += flops;
+        op.bytes += bytes;
+
+        cost.node_count++;
+        cost.flops += flops;
+        cost.bytes += bytes;
+        if (!analyzed) cost.unanalyzed_nodes++;
+    }
+
+    for (auto& kv : by_op) cost.ops.push_back(kv.second);
+    std::sort(cost.ops.begin(), cost.ops.end(), [](const OpCost& a, const OpCost& b) {
+        return a.flops != b.flops ? a.flops > b.flops : a.bytes > b.bytes;
+    });
+
+    // 3. 激活内存：中间张量总量，以及按节点顺序执行、用完即释放时的存活峰值
+    std::unordered_map<std::string, size_t> last_use;
+    for (size_t i = 0; i < graph.nodes.size(); ++i) {
+        for (const auto& name : graph.nodes[i].inputs) last_use[name] = i;
+    }
+    for (const auto& name : graph.outputs) last_use[name] = graph.nodes.size();
+
+    auto activation_bytes = [&](const std::string& name) -> int64_t {
+        if (name.empty() || graph.initializers.count(name)) return 0;
+        const TensorInfo* t = shapes.Get(name);
+        return t ? t->Bytes() : 0;
+    };
+
+    int64_t live = 0;
+    for (const auto& name : graph.inputs) live += activation_bytes(name);
+    cost.activation_bytes = live;
+    cost.peak_activation_bytes = live;
+
+    for (size_t i = 0; i < graph.nodes.size(); ++i) {
+        const Node& node = graph.nodes[i];
+        for (const auto& name : node.outputs) {
+            int64_t b = activation_bytes(name);
+            live += b;
+            cost.activation_bytes += b;
+        }
+        cost.peak_activation_bytes = std::max(cost.peak_activation_bytes, live);
+
+        std::set<std::string> released;
+        for (const auto& name : node.inputs) {
+            auto it = last_use.find(name);
+            if (it != last_use.end() && it->second == i && released.insert(name).second) live -= activation_bytes(name);
+        }
+        for (const auto& name : node.outputs) {
+            if (!last_use.count(name) && released.insert(name).second) live -= activation_bytes(name);
+        }
+    }
+    return cost;
+}
@@ -0,0 +1,28 @@
+#include "NullEngine.h"
+#include <chrono>
+#include <stdexcept>
+
+NullEngine::NullEngine(int64_t input_size, int64_t spin_ns, int64_t output_size)
+    : input_size_(input_size), spin_ns_(spin_ns), output_size_(output_size) {}
+
+std::vector<float> NullEngine::Run(const std::vector<float>& input_data) {
+    return Spin(input_data, nullptr);
+}
+
+std::vector<float> NullEngine::Run(const std::vector<float>& input_data, CancelToken& cancel) {
+    return Spin(input_data, &cancel);
+}
+
+std::vector<float> NullEngine::Spin(const std::vector<float>& input_data, const CancelToken* cancel) {
+    if (cancel && cancel->IsCancelled()) throw std::runtime_error("Run cancelled");
+    if (spin_ns_ > 0) {
+        // 忙等而非 sleep：占用 CPU 的方式与真实推理一致，且不受调度器唤醒延迟影响
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(spin_ns_);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (cancel && cancel->IsCancelled()) throw std::runtime_error("Run cancelled");
+        }
+    }
+    std::vector<float> output(output_size_);
+    if (!output.empty() && !input_data.empty()) output[0] = input_data[0];
+    return output;
+}
@@ -0,0 +1,213 @@
+#include "PowerMonitor.h"
+#include <algorithm>
+#include <cctype>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <unistd.h>
+
+namespace {
+
+// 读取单个整数的 sysfs 文件，失败返回 false
+bool ReadInt64(const std::string& path, int64_t& value) {
+    std::ifstream file(path);
+    return static_cast<bool>(file >> value);
+}
+
+// 列出目录下的条目名
+std::vector<std::string> ListDir(const std::string& dir) {
+    std::vector<std::string> names;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return names;
+    while (dirent* entry = readdir(d)) {
+        names.push_back(entry->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// "prefix" 后全为数字
+bool IsNumberedEntry(const std::string& name, const std::string& prefix) {
+    if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) return false;
+    return std::all_of(name.begin() + prefix.size(), name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+}
+
+} // namespace
+
+PowerMonitor::PowerMonitor(const std::string& powercap_dir, const std::string& cpu_dir,
+                           const std::string& proc_stat, const std::vector<int>& cpus)
+    : proc_stat_path_(proc_stat) {
+    // 0. 可运行的 CPU 集合 (为空表示不过滤)
+    std::set<int> allowed(cpus.begin(), cpus.end());
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (allowed.empty() && sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) allowed.insert(cpu);
+        }
+    }
+
+    // 1. 顶层 RAPL 域：intel-rapl:0、intel-rapl:1 ... (intel-rapl:0:0 等子域跳过)
+    for (const auto& name : ListDir(powercap_dir)) {
+        if (!IsNumberedEntry(name, "intel-rapl:")) continue;
+        EnergyDomain domain;
+        domain.energy_path = powercap_dir + "/" + name + "/energy_uj";
+        if (!ReadInt64(domain.energy_path, domain.last_uj)) continue; // 不存在或无权限
+        ReadInt64(powercap_dir + "/" + name + "/max_energy_range_uj", domain.max_range_uj);
+        domains_.push_back(domain);
+    }
+
+    // 2. 每个 CPU 的频率与节流计数
+    for (const auto& name : ListDir(cpu_dir)) {
+        if (!IsNumberedEntry(name, "cpu")) continue;
+        std::string base = cpu_dir + "/" + name;
+        int cpu = std::stoi(name.substr(3));
+        bool runnable = allowed.empty() || allowed.count(cpu) > 0;
+        int64_t value = 0;
+
+        if (runnable && ReadInt64(base + "/cpufreq/scaling_cur_freq", value)) {
+            freq_paths_.push_back(base + "/cpufreq/scaling_cur_freq");
+            freq_cpus_.push_back(cpu);
+            if (base_freq_mhz_ == 0.0 && ReadInt64(base + "/cpufreq/base_frequency", value)) {
+                base_freq_mhz_ = value / 1000.0;
+            }
+        }
+        if (runnable && ReadInt64(base + "/thermal_throttle/core_throttle_count", value)) {
+            core_throttle_paths_.push_back(base + "/thermal_throttle/core_throttle_count");
+        }
+        int64_t package_id = 0;
+        ReadInt64(base + "/topology/physical_package_id", package_id);
+        if (!package_throttle_paths_.count(static_cast<int>(package_id)) &&
+            ReadInt64(base + "/thermal_throttle/package_throttle_count", value)) {
+            package_throttle_paths_[static_cast<int>(package_id)] = base + "/thermal_throttle/package_throttle_count";
+        }
+    }
+}
+
+void PowerMonitor::Begin() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    baseline_ = SampleLocked();
+    begin_time_ = std::chrono::steady_clock::now();
+    ended_ = false;
+    freq_sum_mhz_ = 0.0;
+    freq_samples_ = 0;
+    min_freq_mhz_ = 0.0;
+    below_base_events_ = 0;
+    below_base_ = false;
+}
+
+PowerSample PowerMonitor::Sample() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PowerSample sample = SampleLocked();
+    if (sample.avg_freq_mhz > 0 && !ended_) {
+        freq_sum_mhz_ += sample.avg_freq_mhz;
+        min_freq_mhz_ = freq_samples_ == 0 ? sample.min_freq_mhz : std::min(min_freq_mhz_, sample.min_freq_mhz);
+        freq_samples_++;
+
+        bool below = base_freq_mhz_ > 0 && sample.min_freq_mhz < base_freq_mhz_;
+        if (below && !below_base_) below_base_events_++;
+        below_base_ = below;
+    }
+    return sample;
+}
+
+void PowerMonitor::End() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    end_ = SampleLocked();
+    end_time_ = std::chrono::steady_clock::now();
+    ended_ = true;
+}
+
+PowerSummary PowerMonitor::Summarize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PowerSample end = ended_ ? end_ : SampleLocked();
+    auto end_time = ended_ ? end_time_ : std::chrono::steady_clock::now();
+    PowerSummary summary;
+    summary.energy_joules = end.energy_joules - baseline_.energy_joules;
+    summary.duration_sec = std::chrono::duration<double>(end_time - begin_time_).count();
+    summary.throttle_events = end.throttle_count - baseline_.throttle_count;
+    summary.below_base_events = below_base_events_;
+    if (freq_samples_ > 0) {
+        summary.avg_freq_mhz = freq_sum_mhz_ / freq_samples_;
+        summary.min_freq_mhz = min_freq_mhz_;
+    } else {
+        summary.avg_freq_mhz = end.avg_freq_mhz;
+        summary.min_freq_mhz = end.min_freq_mhz;
+    }
+    return summary;
+}
+
+PowerSample PowerMonitor::SampleLocked() {
+    PowerSample sample;
+
+    for (auto& domain : domains_) {
+        int64_t current = 0;
+        if (!ReadInt64(domain.energy_path, current)) continue;
+        int64_t delta = current - domain.last_uj;
+        if (delta < 0) delta += domain.max_range_uj; // 计数器回绕
+        if (delta > 0) domain.accumulated_joules += delta / 1e6;
+        domain.last_uj = current;
+        sample.energy_joules += domain.accumulated_joules;
+    }
+
+    std::set<int> busy;
+    bool filter_busy = ReadBusyCpus(busy);
+    double sum_mhz = 0.0;
+    int count = 0;
+    for (size_t i = 0; i < freq_paths_.size(); ++i) {
+        if (filter_busy && !busy.count(freq_cpus_[i])) continue;
+        int64_t khz = 0;
+        if (!ReadInt64(freq_paths_[i], khz)) continue; // CPU 可能已下线
+        double mhz = khz / 1000.0;
+        sum_mhz += mhz;
+        sample.min_freq_mhz = count == 0 ? mhz : std::min(sample.min_freq_mhz, mhz);
+        count++;
+    }
+    if (count > 0) sample.avg_freq_mhz = sum_mhz / count;
+
+    for (const auto& path : core_throttle_paths_) {
+        int64_t value = 0;
+        if (ReadInt64(path, value)) sample.throttle_count += value;
+    }
+    for (const auto& kv : package_throttle_paths_) {
+        int64_t value = 0;
+        if (ReadInt64(kv.second, value)) sample.throttle_count += value;
+    }
+    return sample;
+}
+
+bool PowerMonitor::ReadBusyCpus(std::set<int>& busy) {
+    std::ifstream stat(proc_stat_path_);
+    if (!stat.is_open()) return false;
+
+    // 格式: cpuN user nice system idle iowait irq softirq steal ...
+    std::map<int, std::pair<uint64_t, uint64_t>> current;
+    std::string line;
+    while (std::getline(stat, line)) {
+        if (line.compare(0, 3, "cpu") != 0 || line.size() < 4 || !std::isdigit(static_cast<unsigned char>(line[3]))) {
+            continue; // 跳过汇总行 "cpu " 与其他统计
+        }
+        std::istringstream fields(line.substr(3));
+        int cpu = 0;
+        uint64_t value = 0, total = 0, idle = 0;
+        fields >> cpu;
+        for (int column = 0; fields >> value && column < 8; ++column) {
+            total += value;
+            if (column == 3 || column == 4) idle += value; // idle + iowait
+        }
+        current[cpu] = {total - idle, total};
+    }
+
+    bool have_previous = !last_cpu_times_.empty();
+    for (const auto& kv : current) {
+        auto prev = last_cpu_times_.find(kv.first);
+        if (prev == last_cpu_times_.end()) continue;
+        uint64_t busy_delta = kv.second.first - prev->second.first;
+        uint64_t total_delta = kv.second.second - prev->second.second;
+        if (total_delta > 0 && busy_delta * 2 >= total_delta) busy.insert(kv.first);
+    }
+    last_cpu_times_ = std::move(current);
+    return have_previous && !last_cpu_times_.empty();
+}
@@ -0,0 +1,274 @@
+#include "ProcessRunner.h"
+#include "InferenceEngine.h"
+#include "LatencyHistogram.h"
+#include "PowerMonitor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+// 跨进程共享的原子量必须是无锁的，否则其内部锁不在共享内存中
+static_assert(std::atomic<int64_t>::is_always_lock_free, "int64_t atomics must be lock-free");
+
+// 单个 Worker 进程的结果槽位 (仅由对应 Worker 写入)
+struct alignas(64) WorkerSlot {
+    LatencyHistogram histogram;
+    uint64_t failed_requests;
+    int64_t begin_ns; // 开始取单时刻 (CLOCK_MONOTONIC，跨进程可比)
+    int64_t end_ns;   // 最后一个请求完成时刻
+};
+
+// 共享内存段头部，后面紧跟 processes 个 WorkerSlot
+struct SharedState {
+    std::atomic<int> ready{0};   // 已完成加载与预热的 Worker 数
+    std::atomic<int> failed{0};  // 加载失败的 Worker 数
+    std::atomic<int> go{0};      // 启动屏障：1 开始压测，-1 放弃
+    alignas(64) std::atomic<int64_t> remaining_requests{0};
+
+    WorkerSlot* Slots() {
+        return reinterpret_cast<WorkerSlot*>(reinterpret_cast<char*>(this) + SlotsOffset());
+    }
+    static size_t SlotsOffset() {
+        return (sizeof(SharedState) + alignof(WorkerSlot) - 1) / alignof(WorkerSlot) * alignof(WorkerSlot);
+    }
+};
+
+int64_t MonotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Worker 进程主体：加载模型 -> 预热 -> 屏障 -> 抢单压测
+int WorkerMain(const std::string& model_path, int opt_level, const MemoryOptions& memory,
+               const BenchmarkConfig& config, SharedState* shared, int index) {
+    WorkerSlot& slot = shared->Slots()[index];
+
+    std::unique_ptr<InferenceEngine> engine;
+    std::vector<float> input_data;
+    try {
+        engine = std::make_unique<InferenceEngine>();
+        engine->LoadModel(model_path, opt_level, memory);
+
+        input_data.resize(engine->GetInputSize());
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (auto& val : input_data) val = dist(gen);
+
+        for (int i = 0; i < config.warmup_rounds; ++i) {
+            engine->Run(input_data);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Worker " << index << "] " << e.what() << std::endl;
+        shared->failed++;
+        return 1;
+    }
+
+    // 启动屏障：等待协调者放行，避免先加载完的进程提前开跑
+    shared->ready++;
+    int go = 0;
+    while ((go = shared->go.load(std::memory_order_acquire)) == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    if (go < 0) return 1;
+
+    slot.begin_ns = MonotonicNowNs();
+    while (shared->remaining_requests.fetch_sub(1) > 0) {
+        auto t1 = std::chrono::steady_clock::now();
+        try {
+            engine->Run(input_data);
+        } catch (const std::exception&) {
+            slot.failed_requests++;
+            continue;
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        slot.histogram.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+    }
+    slot.end_ns = MonotonicNowNs();
+    return 0;
+}
+
+} // namespace
+
+ProcessRunner::ProcessRunner(const std::string& model_path, int opt_level, SystemMonitor& monitor,
+                             const MemoryOptions& memory)
+    : model_path_(model_path), opt_level_(opt_level), monitor_(monitor), memory_(memory) {}
+
+BenchmarkResult ProcessRunner::Run(const BenchmarkConfig& config) {
+    BenchmarkResult result;
+    const int processes = std::max(config.processes, 1);
+
+    // 1. 创建匿名共享内存 (fork 后父子进程映射同一物理页)
+    size_t shm_bytes = SharedState::SlotsOffset() + sizeof(WorkerSlot) * processes;
+    void* shm = mmap(nullptr, shm_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shm == MAP_FAILED) {
+        throw std::runtime_error(std::string("Failed to create shared memory: ") + strerror(errno));
+    }
+    SharedState* shared = new (shm) SharedState();
+    shared->remaining_requests = config.requests;
+    for (int i = 0; i < processes; ++i) {
+        WorkerSlot* slot = new (&shared->Slots()[i]) WorkerSlot();
+        slot->histogram.Reset();
+    }
+
+    // 2. fork Worker 进程 (先刷出缓冲区，避免子进程重复输出)
+    std::cout.flush();
+    std::cerr.flush();
+    std::vector<pid_t> pids;
+    for (int i = 0; i < processes; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            shared->go = -1;
+            for (pid_t p : pids) waitpid(p, nullptr, 0);
+            munmap(shm, shm_bytes);
+            throw std::runtime_error(std::string("fork failed: ") + strerror(errno));
+        }
+        if (pid == 0) {
+            int rc = WorkerMain(model_path_, opt_level_, memory_, config, shared, i);
+            std::cout.flush();
+            _exit(rc);
+        }
+        pids.push_back(pid);
+    }
+
+    // 3. 等待所有 Worker 就绪
+    // 健康的 Worker 在放行前不会退出，提前退出 (如加载时崩溃) 视为失败
+    bool worker_died = false;
+    std::vector<bool> reaped(processes, false);
+    while (shared->ready + shared->failed < processes && !worker_died) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        for (int i = 0; i < processes; ++i) {
+            if (!reaped[i] && waitpid(pids[i], nullptr, WNOHANG) == pids[i]) {
+                reaped[i] = true;
+                worker_died = true;
+            }
+        }
+    }
+    if (shared->failed > 0 || worker_died) {
+        shared->go = -1;
+        for (int i = 0; i < processes; ++i) {
+            if (!reaped[i]) waitpid(pids[i], nullptr, 0);
+        }
+        int failed = std::max(shared->failed.load(), 1);
+        munmap(shm, shm_bytes);
+        throw std::runtime_error(std::to_string(failed) + " worker process(es) failed to load the model");
+    }
+
+    // 4. 启动系统监控线程 (汇总所有 Worker 的 RSS)
+    std::atomic<bool> monitor_running(true);
+    std::atomic<bool> aborted(false);
+    std::vector<double> cpu_samples;
+    std::vector<double> mem_samples;
+    PowerMonitor power;
+
+    std::thread monitor_thread([&]() {
+        while (monitor_running) {
+            power.Sample();
+            double cpu = monitor_.GetCpuUsage();
+            double mem = 0.0;
+            for (pid_t p : pids) mem += monitor_.GetProcessMemoryUsage(p);
+
+            cpu_samples.push_back(cpu);
+            mem_samples.push_back(mem);
+
+            // Watchdog Check：多进程模式下无法收缩单个进程的并发，统一停止派发
+            if (config.memory_limit_mb > 0 && mem > config.memory_limit_mb &&
+                shared->remaining_requests > 0) {
+                std::cerr << "\n[Watchdog] OOM Detected! Total RSS: " << mem
+                          << " MB > Limit: " << config.memory_limit_mb << " MB. Stopping..." << std::endl;
+                result.watchdog_triggers++;
+                if (config.watchdog_action == WatchdogAction::kAbort) aborted = true;
+                shared->remaining_requests = 0;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    });
+
+    // 5. 放行，所有 Worker 同时开始
+    power.Begin();
+    int64_t start_ns = MonotonicNowNs();
+    shared->go.store(1, std::memory_order_release);
+
+    // 6. 等待所有 Worker 退出
+    int crashed = 0;
+    for (pid_t p : pids) {
+        int status = 0;
+        waitpid(p, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) crashed++;
+    }
+    power.End();
+
+    monitor_running = false;
+    if (monitor_thread.joinable()) monitor_thread.join();
+    PowerSummary power_summary = power.Summarize();
+
+    if (crashed > 0) {
+        std::cerr << "[Warning] " << crashed << " worker process(es) exited abnormally." << std::endl;
+    }
+
+    // 7. 汇总数据
+    // 直方图约 22KB，放在堆上
+    auto merged = std::make_unique<LatencyHistogram>();
+    merged->Reset();
+    int64_t end_ns = start_ns;
+    uint64_t failed_requests = 0;
+    for (int i = 0; i < processes; ++i) {
+        const WorkerSlot& slot = shared->Slots()[i];
+        merged->Merge(slot.histogram);
+        end_ns = std::max(end_ns, slot.end_ns);
+        failed_requests += slot.failed_requests;
+    }
+    double total_time_sec = (end_ns - start_ns) / 1e9;
+
+    result.completed_requests = static_cast<int>(merged->total_count);
+    result.failed_requests = static_cast<int>(failed_requests);
+    result.qps = total_time_sec > 0 ? result.completed_requests / total_time_sec : 0.0;
+    result.avg_latency_ms = merged->MeanMs();
+    result.p99_latency_ms = merged->PercentileMs(0.99);
+    result.aborted = aborted;
+    result.final_concurrency = processes;
+
+    if (power.HasEnergy()) {
+        result.energy_available = true;
+        result.energy_joules = power_summary.energy_joules;
+        // 能耗窗口为放行到最后一个 Worker 被回收，与各 Worker 自报的 end_ns 略有出入，功率按窗口自身时长计算
+        result.avg_power_watts = power_summary.duration_sec > 0 ? power_summary.energy_joules / power_summary.duration_sec : 0.0;
+        if (result.completed_requests > 0) {
+            result.joules_per_inference = power_summary.energy_joules / result.completed_requests;
+        }
+        if (power_summary.energy_joules > 0) {
+            result.queries_per_joule = result.completed_requests / power_summary.energy_joules;
+        }
+    }
+    if (power.HasFrequency()) {
+        result.freq_available = true;
+        result.avg_freq_mhz = power_summary.avg_freq_mhz;
+        result.min_freq_mhz = power_summary.min_freq_mhz;
+        result.below_base_events = power_summary.below_base_events;
+    }
+    result.throttle_events = power_summary.throttle_events;
+
+    if (!cpu_samples.empty()) {
+        double sum = std::accumulate(cpu_samples.begin(), cpu_samples.end(), 0.0);
+        result.avg_cpu_usage = sum / cpu_samples.size();
+    }
+    if (!mem_samples.empty()) {
+        result.peak_memory_mb = *std::max_element(mem_samples.begin(), mem_samples.end());
+    }
+
+    munmap(shm, shm_bytes);
+    return result;
+}
@@ -0,0 +1,264 @@
+#include "RequestLog.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kLogMagic[8] = {'I', 'B', 'R', 'E', 'Q', 'L', 'O', 'G'};
+constexpr uint32_t kLogVersion = 1;
+// 文件按 64 MiB 为单位扩展 (预先分配磁盘块，关闭时截断到实际大小)
+constexpr size_t kGrowChunkBytes = 64ull * 1024 * 1024;
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// RequestLogWriter
+// ---------------------------------------------------------------------------
+
+RequestLogWriter::RequestLogWriter(const std::string& path, int num_workers, uint64_t start_unix_ns,
+                                   size_t buffer_records)
+    : buffer_records_(buffer_records > 0 ? buffer_records : 1) {
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to create request log " + path + ": " + strerror(errno));
+    }
+    // 构造失败时析构函数不会运行，需要自行释放已打开的文件与映射
+    try {
+        EnsureCapacity(sizeof(RequestLogHeader));
+
+        RequestLogHeader* header = reinterpret_cast<RequestLogHeader*>(map_);
+        std::memset(header, 0, sizeof(RequestLogHeader));
+        std::memcpy(header->magic, kLogMagic, sizeof(kLogMagic));
+        header->version = kLogVersion;
+        header->record_size = sizeof(RequestLogRecord);
+        header->start_unix_ns = start_unix_ns;
+
+        // 每个 Worker 一个活动缓冲区 + 一个备用缓冲区，另加 2 个供后台刷盘时周转
+        int workers = num_workers > 0 ? num_workers : 1;
+        size_t total = static_cast<size_t>(workers) * 2 + 2;
+        for (size_t i = 0; i < total; ++i) {
+            auto buffer = std::make_unique<Buffer>();
+            buffer->records = std::make_unique<RequestLogRecord[]>(buffer_records_);
+            buffers_.push_back(std::move(buffer));
+        }
+        for (int w = 0; w < workers; ++w) {
+            active_.push_back(buffers_[w].get());
+        }
+        for (size_t i = workers; i < total; ++i) {
+            free_.push_back(buffers_[i].get());
+        }
+
+        flusher_ = std::thread(&RequestLogWriter::FlushLoop, this);
+    } catch (...) {
+        if (map_ != nullptr) munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+        close(fd_);
+        fd_ = -1;
+        throw;
+    }
+}
+
+RequestLogWriter::~RequestLogWriter() {
+    Close();
+}
+
+void RequestLogWriter::Submit(int worker) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    full_.push_back(active_[worker]);
+    flush_cv_.notify_one();
+    // 后台线程跟不上时在这里反压，而不是无限增长内存
+    free_cv_.wait(lock, [this] { return !free_.empty(); });
+    active_[worker] = free_.back();
+    free_.pop_back();
+}
+
+void RequestLogWriter::FlushLoop() {
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        flush_cv_.wait(lock, [this] { return closing_ || !full_.empty(); });
+        if (full_.empty()) {
+            break; // closing_ 且已全部写完
+        }
+        Buffer* buffer = full_.front();
+        full_.pop_front();
+        lock.unlock();
+
+        try {
+            WriteRecords(buffer->records.get(), buffer->size);
+        } catch (const std::exception& e) {
+            // 磁盘写满等情况下丢弃该批记录，不影响压测本身
+            std::cerr << "[RequestLog] " << e.what() << std::endl;
+        }
+        buffer->size = 0;
+
+        lock.lock();
+        free_.push_back(buffer);
+        free_cv_.notify_one();
+    }
+}
+
+void RequestLogWriter::EnsureCapacity(size_t required_bytes) {
+    if (required_bytes <= map_size_) return;
+
+    size_t new_size = map_size_ + kGrowChunkBytes;
+    if (new_size < required_bytes) new_size = required_bytes;
+
+    // 先真正分配磁盘块再扩大映射：稀疏文件经 MAP_SHARED 写入时，磁盘写满会触发 SIGBUS 而不是返回错误。
+    // 剩余空间不足一整块时退回只预留本次需要的大小；仍然失败则抛出，由调用方丢弃该批记录
+    int err = posix_fallocate(fd_, static_cast<off_t>(map_size_), static_cast<off_t>(new_size - map_size_));
+    if (err != 0 && new_size > required_bytes) {
+        new_size = required_bytes;
+        err = posix_fallocate(fd_, static_cast<off_t>(map_size_), static_cast<off_t>(new_size - map_size_));
+    }
+    if (err != 0) {
+        throw std::runtime_error(std::string("Failed to grow request log: ") + strerror(err));
+    }
+    void* addr = map_ == nullptr
+        ? mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+        : mremap(map_, map_size_, new_size, MREMAP_MAYMOVE);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(std::string("Failed to map request log: ") + strerror(errno));
+    }
+    map_ = static_cast<uint8_t*>(addr);
+    map_size_ = new_size;
+}
+
+void RequestLogWriter::WriteRecords(const RequestLogRecord* records, size_t count) {
+    if (count == 0) return;
+    size_t offset = sizeof(RequestLogHeader) + record_count_ * sizeof(RequestLogRecord);
+    size_t bytes = count * sizeof(RequestLogRecord);
+    EnsureCapacity(offset + bytes);
+    std::memcpy(map_ + offset, records, bytes);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    record_count_ += count;
+    // 文件头中的计数随每批更新，进程异常退出时读取器仍能确定有效范围
+    reinterpret_cast<RequestLogHeader*>(map_)->record_count = record_count_;
+}
+
+void RequestLogWriter::Close() {
+    if (fd_ < 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Buffer* buffer : active_) {
+            if (buffer->size > 0) full_.push_back(buffer);
+        }
+        active_.clear();
+        closing_ = true;
+    }
+    flush_cv_.notify_one();
+    if (flusher_.joinable()) flusher_.join();
+
+    size_t final_size = sizeof(RequestLogHeader) + record_count_ * sizeof(RequestLogRecord);
+    msync(map_, final_size, MS_SYNC);
+    munmap(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+
+    if (ftruncate(fd_, static_cast<off_t>(final_size)) != 0) {
+        // 截断失败不影响数据正确性，读取器以文件头中的计数为准
+    }
+    close(fd_);
+    fd_ = -1;
+}
+
+uint64_t RequestLogWriter::GetRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return record_count_;
+}
+
+// ---------------------------------------------------------------------------
+// RequestLogReader
+// ---------------------------------------------------------------------------
+
+RequestLogReader::~RequestLogReader() {
+    Unmap();
+}
+
+void RequestLogReader::Unmap() {
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+    map_size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+    count_ = 0;
+}
+
+void RequestLogReader::Open(const std::string& path) {
+    Unmap();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open request log " + path + ": " + strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RequestLogHeader)) {
+        close(fd);
+        throw std::runtime_error("Request log too small: " + path);
+    }
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map request log " + path + ": " + strerror(errno));
+    }
+    map_ = static_cast<uint8_t*>(addr);
+    map_size_ = st.st_size;
+    header_ = reinterpret_cast<const RequestLogHeader*>(map_);
+
+    if (std::memcmp(header_->magic, kLogMagic, sizeof(kLogMagic)) != 0 ||
+        header_->version != kLogVersion || header_->record_size != sizeof(RequestLogRecord)) {
+        Unmap();
+        throw std::runtime_error("Not a request log (bad header): " + path);
+    }
+
+    records_ = reinterpret_cast<const RequestLogRecord*>(map_ + sizeof(RequestLogHeader));
+    size_t on_disk = (map_size_ - sizeof(RequestLogHeader)) / sizeof(RequestLogRecord);
+    count_ = header_->record_count < on_disk ? header_->record_count : on_disk;
+}
+
+bool RequestLogReader::ExportCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    out << "timestamp_ns,latency_ns,worker,shape_bucket,status\n";
+    for (size_t i = 0; i < count_; ++i) {
+        const RequestLogRecord& r = records_[i];
+        out << r.timestamp_ns << ',' << r.latency_ns << ',' << r.worker << ','
+            << r.shape_bucket << ',' << r.status << '\n';
+    }
+    return out.good();
+}
+
+bool RequestLogReader::ExportColumns(const std::string& prefix) const {
+    // 逐列写出，每列一个定长数组文件
+    auto write_column = [&](const std::string& suffix, auto getter) {
+        using T = decltype(getter(records_[0]));
+        std::ofstream out(prefix + suffix, std::ios::binary);
+        if (!out.is_open()) return false;
+        for (size_t i = 0; i < count_; ++i) {
+            T value = getter(records_[i]);
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        return out.good();
+    };
+
+    bool ok = true;
+    ok &= write_column(".timestamp_ns.u64", [](const RequestLogRecord& r) { return r.timestamp_ns; });
+    ok &= write_column(".latency_ns.u64", [](const RequestLogRecord& r) { return r.latency_ns; });
+    ok &= write_column(".worker.u32", [](const RequestLogRecord& r) { return r.worker; });
+    ok &= write_column(".shape_bucket.u16", [](const RequestLogRecord& r) { return r.shape_bucket; });
+    ok &= write_column(".status.u16", [](const RequestLogRecord& r) { return r.status; });
+    return ok;
+}
@@ -0,0 +1,156 @@
+#include "Roofline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 计算密集的内核按多个指令集版本编译，由 ifunc 在运行时选择当前 CPU 支持的最优版本
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define INFERBENCH_MULTIVERSION __attribute__((target_clones("avx512f", "arch=haswell", "default")))
+#else
+#define INFERBENCH_MULTIVERSION
+#endif
+
+namespace {
+
+// 独立的乘加依赖链数：足以填满 FMA 流水线 (延迟 × 端口数 × 向量宽度)
+constexpr int kFmaChains = 64;
+
+INFERBENCH_MULTIVERSION
+float FmaKernel(int64_t iterations, float mul, float add) {
+    float acc[kFmaChains];
+    for (int j = 0; j < kFmaChains; ++j) acc[j] = 1.0f + j * 1e-3f;
+    for (int64_t i = 0; i < iterations; ++i) {
+        for (int j = 0; j < kFmaChains; ++j) acc[j] = acc[j] * mul + add;
+    }
+    float sum = 0.0f;
+    for (int j = 0; j < kFmaChains; ++j) sum += acc[j];
+    return sum;
+}
+
+INFERBENCH_MULTIVERSION
+void TriadKernel(float* a, const float* b, const float* c, size_t n, float scalar) {
+    for (size_t i = 0; i < n; ++i) a[i] = b[i] + scalar * c[i];
+}
+
+// 自旋屏障：让所有线程同时开始，避免线程创建开销计入测量
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int count) : count_(count) {}
+
+    void Wait() {
+        int generation = generation_.load();
+        if (arrived_.fetch_add(1) + 1 == count_) {
+            arrived_ = 0;
+            generation_++;
+        } else {
+            while (generation_.load() == generation) std::this_thread::yield();
+        }
+    }
+
+private:
+    const int count_;
+    std::atomic<int> arrived_{0};
+    std::atomic<int> generation_{0};
+};
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 运行 reps 轮，每轮所有线程并发执行 work(thread_index)，返回最快一轮的墙钟时间
+template <typename Work>
+double BestParallelTime(int threads, int reps, Work work) {
+    SpinBarrier barrier(threads + 1);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int r = 0; r < reps; ++r) {
+                barrier.Wait();
+                work(t);
+                barrier.Wait();
+            }
+        });
+    }
+
+    double best = 0.0;
+    for (int r = 0; r < reps; ++r) {
+        barrier.Wait();
+        auto start = std::chrono::steady_clock::now();
+        barrier.Wait();
+        double elapsed = SecondsSince(start);
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    for (auto& w : workers) w.join();
+    return best;
+}
+
+} // namespace
+
+MachinePeak Roofline::MeasureMachinePeak(int threads, size_t array_bytes) {
+    MachinePeak peak;
+    peak.threads = std::max(threads, 1);
+
+    // 1. 算力：先单线程校准迭代次数，使每轮约 200ms
+    volatile float sink = 0.0f; // 防止内核被优化掉
+    const float mul = 0.999999f, add = 1e-6f;
+    int64_t iterations = 1 << 16;
+    auto calib_start = std::chrono::steady_clock::now();
+    sink = sink + FmaKernel(iterations, mul, add);
+    double calib_sec = std::max(SecondsSince(calib_start), 1e-6);
+    iterations = std::max<int64_t>(static_cast<int64_t>(iterations * 0.2 / calib_sec), 1 << 16);
+
+    std::vector<float> results(peak.threads);
+    double fma_sec = BestParallelTime(peak.threads, 3, [&](int t) {
+        results[t] = FmaKernel(iterations, mul, add);
+    });
+    for (float r : results) sink = sink + r;
+    double total_flops = 2.0 * kFmaChains * static_cast<double>(iterations) * peak.threads;
+    peak.peak_gflops = fma_sec > 0 ? total_flops / fma_sec / 1e9 : 0.0;
+
+    // 2. 带宽：STREAM Triad，各线程处理自己的分块 (首次写入由本线程完成，NUMA 友好)
+    size_t n = std::max<size_t>(array_bytes / sizeof(float), peak.threads);
+    std::unique_ptr<float[]> a(new float[n]);
+    std::unique_ptr<float[]> b(new float[n]);
+    std::unique_ptr<float[]> c(new float[n]);
+    size_t chunk = (n + peak.threads - 1) / peak.threads;
+    auto range = [&](int t, size_t& begin, size_t& count) {
+        begin = std::min(n, chunk * t);
+        count = std::min(n, begin + chunk) - begin;
+    };
+
+    BestParallelTime(peak.threads, 1, [&](int t) {
+        size_t begin, count;
+        range(t, begin, count);
+        std::fill(a.get() + begin, a.get() + begin + count, 0.0f);
+        std::fill(b.get() + begin, b.get() + begin + count, 1.0f);
+        std::fill(c.get() + begin, c.get() + begin + count, 2.0f);
+    });
+    double triad_sec = BestParallelTime(peak.threads, 5, [&](int t) {
+        size_t begin, count;
+        range(t, begin, count);
+        TriadKernel(a.get() + begin, b.get() + begin, c.get() + begin, count, 3.0f);
+    });
+    sink = sink + a[n / 2];
+    peak.peak_bandwidth_gbs = triad_sec > 0 ? 3.0 * n * sizeof(float) / triad_sec / 1e9 : 0.0;
+
+    return peak;
+}
+
+RooflineReport Roofline::BuildReport(const ModelCost& cost, const MachinePeak& peak, double qps) {
+    RooflineReport report;
+    report.achieved_gflops = cost.flops * qps / 1e9;
+    report.achieved_bandwidth_gbs = cost.bytes * qps / 1e9;
+    report.arithmetic_intensity = cost.ArithmeticIntensity();
+    if (peak.peak_bandwidth_gbs > 0) {
+        report.ridge_point = peak.peak_gflops / peak.peak_bandwidth_gbs;
+    }
+    report.attainable_gflops = std::min(peak.peak_gflops, report.arithmetic_intensity * peak.peak_bandwidth_gbs);
+    if (report.attainable_gflops > 0) {
+        report.efficiency = report.achieved_gflops / report.attainable_gflops;
+    }
+    report.memory_bound = report.arithmetic_intensity < report.ridge_point;
+    return report;
+}
@@ -3,10 +3,16 @@
 #include <sstream>
 #include <iostream>
 #include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
-double SystemMonitor::GetMemoryUsage() {
-    // 打开当前进程的状态文件 /proc/self/stat
-    std::ifstream stat_file("/proc/self/stat");
+namespace {
+
+// 从 /proc/[pid]/stat 中读取 RSS (MB)
+double ReadRssMb(const std::string& stat_path) {
+    // 打开进程的状态文件 /proc/[pid]/stat
+    std::ifstream stat_file(stat_path);
     if (!stat_file.is_open()) {
         return 0.0;
     }
@@ -30,6 +36,16 @@ double SystemMonitor::GetMemoryUsage() {
     return (static_cast<double>(rss) * page_size) / (1024.0 * 1024.0);
 }
 
+} // namespace
+
+double SystemMonitor::GetMemoryUsage() {
+    return ReadRssMb("/proc/self/stat");
+}
+
+double SystemMonitor::GetProcessMemoryUsage(int pid) {
+    return ReadRssMb("/proc/" + std::to_string(pid) + "/stat");
+}
+
 double SystemMonitor::GetCpuUsage() {
     // 加锁，防止多线程同时修改 last_total_cpu_time_ 等状态
     std::lock_guard<std::mutex> lock(mutex_);
@@ -88,3 +104,18 @@ bool SystemMonitor::CheckMemoryLimit(double limit_mb) {
     double current_usage = GetMemoryUsage();
     return current_usage > limit_mb;
 }
+
+int64_t SystemMonitor::GetHeapInUseBytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    // uordblks: 普通分配中正在使用的字节；hblkhd: 通过 mmap 分配的大块
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<int64_t>(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    // 旧版 glibc 的 mallinfo 字段为 int，超过 2GB 会溢出
+    struct mallinfo info = mallinfo();
+    return static_cast<int64_t>(static_cast<unsigned int>(info.uordblks)) +
+           static_cast<int64_t>(static_cast<unsigned int>(info.hblkhd));
+#else
+    return 0;
+#endif
+}
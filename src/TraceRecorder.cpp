@@ -0,0 +1,125 @@
+#include "TraceRecorder.h"
+#include "RequestLog.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sys/resource.h>
+
+ThreadUsage ThreadUsage::Capture() {
+    ThreadUsage usage;
+    struct rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+        usage.voluntary_ctx_switches = ru.ru_nvcsw;
+        usage.involuntary_ctx_switches = ru.ru_nivcsw;
+        usage.minor_faults = ru.ru_minflt;
+        usage.major_faults = ru.ru_majflt;
+    }
+    return usage;
+}
+
+TraceRecorder::TraceRecorder(int num_workers, size_t capacity_per_worker)
+    : rings_(std::max(num_workers, 1)) {
+    // 预分配全部槽位，记录阶段不再分配内存
+    for (auto& ring : rings_) {
+        ring.spans.resize(std::max<size_t>(capacity_per_worker, 1));
+    }
+}
+
+void TraceRecorder::AddCounter(const std::string& name, int64_t timestamp_ns, double value) {
+    std::lock_guard<std::mutex> lock(counter_mutex_);
+    counters_.push_back({name, timestamp_ns, value});
+}
+
+uint64_t TraceRecorder::GetDroppedCount() const {
+    uint64_t dropped = 0;
+    for (const auto& ring : rings_) {
+        if (ring.count > ring.spans.size()) dropped += ring.count - ring.spans.size();
+    }
+    return dropped;
+}
+
+namespace {
+
+const char* StatusName(uint16_t status) {
+    switch (status) {
+        case kRequestOk: return "ok";
+        case kRequestError: return "error";
+        case kRequestRejected: return "rejected";
+        case kRequestTimeout: return "timeout";
+        default: return "unknown";
+    }
+}
+
+} // namespace
+
+bool TraceRecorder::ExportChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    // Chrome Trace 的 ts/dur 单位为微秒
+    auto us = [](int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"InferBench\"}}";
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"monitor\"}}";
+
+    for (size_t w = 0; w < rings_.size(); ++w) {
+        const Ring& ring = rings_[w];
+        int tid = static_cast<int>(w) + 1;
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"worker " << w << "\"}}";
+
+        // 从最旧的记录开始输出
+        size_t cap = ring.spans.size();
+        size_t n = static_cast<size_t>(std::min<uint64_t>(ring.count, cap));
+        size_t first = ring.count > cap ? static_cast<size_t>(ring.count % cap) : 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            const RequestSpan& s = ring.spans[(first + i) % cap];
+            int64_t total_ns = s.queue_ns + s.dispatch_ns + s.infer_ns + s.post_ns;
+            int64_t dispatch_start = s.start_ns + s.queue_ns;
+            int64_t infer_start = dispatch_start + s.dispatch_ns;
+
+            out << ",\n{\"name\":\"request\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << us(s.start_ns) << ",\"dur\":" << us(total_ns)
+                << ",\"args\":{\"id\":" << s.request_id
+                << ",\"status\":\"" << StatusName(s.status) << "\""
+                << ",\"latency_ms\":" << static_cast<double>(s.infer_ns) / 1e6
+                << ",\"cpu\":" << s.cpu
+                << ",\"voluntary_ctx_switches\":" << s.voluntary_ctx_switches
+                << ",\"involuntary_ctx_switches\":" << s.involuntary_ctx_switches
+                << ",\"minor_faults\":" << s.minor_faults
+                << ",\"major_faults\":" << s.major_faults << "}}";
+            if (s.queue_ns > 0) {
+                out << ",\n{\"name\":\"queue\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                    << ",\"ts\":" << us(s.start_ns) << ",\"dur\":" << us(s.queue_ns) << "}";
+            }
+            if (s.dispatch_ns > 0) {
+                out << ",\n{\"name\":\"dispatch\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                    << ",\"ts\":" << us(dispatch_start) << ",\"dur\":" << us(s.dispatch_ns) << "}";
+            }
+            if (s.status != kRequestRejected) {
+                out << ",\n{\"name\":\"inference\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                    << ",\"ts\":" << us(infer_start) << ",\"dur\":" << us(s.infer_ns) << "}";
+            }
+            if (s.post_ns > 0) {
+                out << ",\n{\"name\":\"post\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                    << ",\"ts\":" << us(infer_start + s.infer_ns) << ",\"dur\":" << us(s.post_ns) << "}";
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(counter_mutex_);
+        for (const auto& c : counters_) {
+            out << ",\n{\"name\":\"" << c.name << "\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":"
+                << us(c.timestamp_ns) << ",\"args\":{\"value\":" << c.value << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
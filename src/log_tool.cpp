@@ -0,0 +1,96 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <iomanip>
+#include <getopt.h>
+
+#include "RequestLog.h"
+
+// 打印使用说明
+void PrintUsage(const char* name) {
+    std::cout << "Usage: " << name << " <request_log.bin> [OPTIONS]\n"
+              << "Options:\n"
+              << "  -c, --csv <path>        Export records as CSV\n"
+              << "  -C, --columns <prefix>  Export one raw little-endian array file per column\n"
+              << "  -h, --help              Show this help message\n";
+}
+
+int main(int argc, char** argv) {
+    std::string csv_path;
+    std::string columns_prefix;
+
+    struct option long_options[] = {
+        {"csv", required_argument, 0, 'c'},
+        {"columns", required_argument, 0, 'C'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    int option_index = 0;
+    while ((opt = getopt_long(argc, argv, "c:C:h", long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'c': csv_path = optarg; break;
+            case 'C': columns_prefix = optarg; break;
+            case 'h': PrintUsage(argv[0]); return 0;
+            default: PrintUsage(argv[0]); return 1;
+        }
+    }
+
+    if (optind >= argc) {
+        std::cerr << "Error: request log path is required.\n";
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        RequestLogReader reader;
+        reader.Open(argv[optind]);
+
+        // 摘要
+        uint64_t first_ts = 0, last_ts = 0, errors = 0, rejected = 0, timeouts = 0;
+        double latency_sum_ms = 0.0;
+        for (size_t i = 0; i < reader.size(); ++i) {
+            const RequestLogRecord& r = reader[i];
+            if (i == 0 || r.timestamp_ns < first_ts) first_ts = r.timestamp_ns;
+            last_ts = std::max(last_ts, r.timestamp_ns + r.latency_ns);
+            latency_sum_ms += r.latency_ns / 1e6;
+            if (r.status == kRequestRejected) rejected++;
+            else if (r.status == kRequestTimeout) timeouts++;
+            else if (r.status != kRequestOk) errors++;
+        }
+        double duration_sec = (last_ts - first_ts) / 1e9;
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Records:        " << reader.size() << std::endl;
+        std::cout << "Duration:       " << duration_sec << " s" << std::endl;
+        if (reader.size() > 0) {
+            std::cout << "Avg Latency:    " << latency_sum_ms / reader.size() << " ms" << std::endl;
+            std::cout << "Errors:         " << errors << std::endl;
+            if (rejected > 0 || timeouts > 0) {
+                std::cout << "Rejected:       " << rejected << std::endl;
+                std::cout << "Timed Out:      " << timeouts << std::endl;
+            }
+        }
+
+        if (!csv_path.empty()) {
+            if (!reader.ExportCsv(csv_path)) {
+                std::cerr << "[Error] Failed to write " << csv_path << std::endl;
+                return 1;
+            }
+            std::cout << "[Export] CSV saved to " << csv_path << std::endl;
+        }
+        if (!columns_prefix.empty()) {
+            if (!reader.ExportColumns(columns_prefix)) {
+                std::cerr << "[Error] Failed to write columns with prefix " << columns_prefix << std::endl;
+                return 1;
+            }
+            std::cout << "[Export] Columns saved to " << columns_prefix << ".*" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Fatal Error] " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
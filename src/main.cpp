@@ -4,17 +4,178 @@
 #include <fstream>
 #include <getopt.h>
 #include <iomanip>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 #include "InferenceEngine.h"
+#include "NullEngine.h"
 #include "SystemMonitor.h"
 #include "BenchmarkRunner.h"
+#include "ColdStartRunner.h"
+#include "ProcessRunner.h"
+#include "InferenceServer.h"
+#include "ModelAnalyzer.h"
+#include "Roofline.h"
+
+// 打印模型静态开销 (单次推理)
+void PrintModelCost(const ModelCost& cost) {
+    const double mb = 1024.0 * 1024.0;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Nodes:                " << cost.node_count;
+    if (cost.unanalyzed_nodes > 0) std::cout << " (" << cost.unanalyzed_nodes << " not analyzed)";
+    std::cout << "\n";
+    std::cout << "  Parameters:           " << cost.parameter_count / 1e6 << " M (" << cost.parameter_bytes / mb << " MB)\n";
+    std::cout << "  Activations:          " << cost.activation_bytes / mb << " MB total, "
+              << cost.peak_activation_bytes / mb << " MB peak live\n";
+    std::cout << "  FLOPs / Inference:    " << cost.flops / 1e9 << " GFLOP\n";
+    std::cout << "  Bytes / Inference:    " << cost.bytes / mb << " MB\n";
+    std::cout << "  Arithmetic Intensity: " << cost.ArithmeticIntensity() << " FLOP/Byte\n";
+    std::cout << "  Top Ops (by FLOPs):\n";
+    for (size_t i = 0; i < cost.ops.size() && i < 8; ++i) {
+        const OpCost& op = cost.ops[i];
+        std::cout << "    " << std::left << std::setw(24) << op.op_type << std::right
+                  << " x" << std::setw(4) << op.count
+                  << std::setw(10) << op.flops / 1e9 << " GFLOP"
+                  << std::setw(10) << op.bytes / mb << " MB";
+        if (cost.flops > 0) std::cout << std::setw(8) << op.flops / cost.flops * 100.0 << " %";
+        std::cout << "\n";
+    }
+}
 
 // 打印模型元数据
-void PrintModelInfo(InferenceEngine& engine) {
+void PrintModelInfo(InferenceEngine& engine, const std::string& model_path) {
     std::cout << "[Probe] Model Inspector:\n";
     // 打印输入 Tensor 的基本信息
     std::cout << "  Input Size (elements): " << engine.GetInputSize() << "\n";
-    std::cout << "  (More details would require InferenceEngine API expansion)\n";
+    // 静态分析只是附加信息：解析器不支持的模型 (如外部数据、超大 protobuf) 仍然正常输出输入信息
+    try {
+        PrintModelCost(ModelAnalyzer::Analyze(model_path));
+    } catch (const std::exception& e) {
+        std::cout << std::flush;
+        std::cerr << "[Warning] Static analysis skipped: " << e.what() << std::endl;
+    }
+}
+
+// 打印冷启动报告
+void PrintColdStartReport(const ColdStartConfig& config, const ColdStartResult& result) {
+    auto print_stats = [](const char* label, const ColdStartStats& stats) {
+        std::cout << label << stats.mean << " ms (stddev " << stats.stddev << ", min " << stats.min
+                  << ", max " << stats.max << ")" << std::endl;
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    print_stats("Load Time:      ", result.load_ms);
+    print_stats("First Infer:    ", result.first_ms);
+    std::cout << "Warm Reference: " << result.warm_ms << " ms (mean of the later half of the curve)" << std::endl;
+    if (!result.recovery_curve_ms.empty()) {
+        print_stats("Recovery First: ", result.recovery_first_ms);
+        int64_t evicted = result.samples.empty() ? 0 : result.samples.back().evicted_bytes;
+        if (evicted < 0) {
+            std::cout << "Page Eviction:  MADV_PAGEOUT not supported by this kernel" << std::endl;
+        } else if (config.evict_pages) {
+            std::cout << "Page Eviction:  " << evicted / (1024.0 * 1024.0) << " MB resident memory paged out (last repetition)"
+                      << (evicted == 0 ? " (no swap configured?)" : "") << std::endl;
+        }
+    }
+    std::cout << "  Request   Cold (ms)" << (result.recovery_curve_ms.empty() ? "" : "   Recovery (ms)") << std::endl;
+    for (size_t i = 0; i < result.curve_ms.size(); ++i) {
+        std::cout << "  " << std::setw(7) << i + 1 << std::setw(12) << result.curve_ms[i];
+        if (i < result.recovery_curve_ms.size()) std::cout << std::setw(16) << result.recovery_curve_ms[i];
+        std::cout << "\n";
+    }
+}
+
+// 保存冷启动 JSON 报告
+void SaveColdStartJson(const std::string& json_path, const std::string& model_path,
+                       const ColdStartConfig& config, const ColdStartResult& result) {
+    std::ofstream json_file(json_path);
+    if (!json_file.is_open()) {
+        std::cerr << "[Error] Failed to save JSON report." << std::endl;
+        return;
+    }
+    auto write_stats = [&](const char* name, const ColdStartStats& stats, bool last) {
+        json_file << "    \"" << name << "\": {\"mean\": " << stats.mean << ", \"stddev\": " << stats.stddev
+                  << ", \"min\": " << stats.min << ", \"max\": " << stats.max << "}" << (last ? "\n" : ",\n");
+    };
+    auto write_array = [&](const char* name, const std::vector<double>& values, bool last) {
+        json_file << "    \"" << name << "\": [";
+        for (size_t i = 0; i < values.size(); ++i) json_file << (i > 0 ? ", " : "") << values[i];
+        json_file << "]" << (last ? "\n" : ",\n");
+    };
+
+    json_file << "{\n";
+    json_file << "  \"model\": \"" << model_path << "\",\n";
+    json_file << "  \"config\": {\n";
+    json_file << "    \"mode\": \"cold_start\",\n";
+    json_file << "    \"repetitions\": " << config.repetitions << ",\n";
+    json_file << "    \"first_requests\": " << config.first_requests << ",\n";
+    json_file << "    \"idle_ms\": " << config.idle_ms << ",\n";
+    json_file << "    \"flush_cache\": " << (config.flush_cache ? "true" : "false") << ",\n";
+    json_file << "    \"evict_pages\": " << (config.evict_pages ? "true" : "false") << "\n";
+    json_file << "  },\n";
+    json_file << "  \"result\": {\n";
+    write_stats("load_ms", result.load_ms, false);
+    write_stats("first_ms", result.first_ms, false);
+    write_stats("recovery_first_ms", result.recovery_first_ms, false);
+    json_file << "    \"warm_ms\": " << result.warm_ms << ",\n";
+    write_array("curve_ms", result.curve_ms, false);
+    write_array("recovery_curve_ms", result.recovery_curve_ms, true);
+    json_file << "  }\n";
+    json_file << "}\n";
+    std::cout << "[Report] Saved to " << json_path << std::endl;
+}
+
+// --null_engine 模式下声明的输入元素个数
+constexpr int64_t kNullEngineInputSize = 1024;
+
+// 仅有长格式的命令行选项 (取值避开单字符选项)
+enum LongOnlyOption {
+    kOptCgroupWatchdog = 256,
+    kOptWatchdogAction,
+    kOptCgroupMemoryRatio,
+    kOptPsiStallUs,
+    kOptTrace,
+    kOptTraceCapacity,
+    kOptRequestLog,
+    kOptProcesses,
+    kOptAllocator,
+    kOptNoMemPattern,
+    kOptNoCpuArena,
+    kOptArenaExtend,
+    kOptArenaInitialChunk,
+    kOptArenaMaxMem,
+    kOptServe,
+    kOptServerWorkers,
+    kOptDeadlineMs,
+    kOptArrivalRate,
+    kOptRoofline,
+    kOptNullEngine,
+    kOptHarnessCalibration,
+    kOptColdStart,
+    kOptColdRequests,
+    kOptIdleMs,
+    kOptFlushCache,
+    kOptEvictPages,
+};
+
+// 解析看门狗处置策略
+bool ParseWatchdogAction(const std::string& str, WatchdogAction& action) {
+    if (str == "stop") action = WatchdogAction::kStopAdmission;
+    else if (str == "shrink") action = WatchdogAction::kShrinkConcurrency;
+    else if (str == "abort") action = WatchdogAction::kAbort;
+    else return false;
+    return true;
+}
+
+// 解析分配器模式
+bool ParseAllocatorMode(const std::string& str, AllocatorMode& mode) {
+    if (str == "session") mode = AllocatorMode::kSession;
+    else if (str == "shared") mode = AllocatorMode::kSharedArena;
+    else if (str == "tracking") mode = AllocatorMode::kTracking;
+    else return false;
+    return true;
 }
 
 // 打印使用说明
@@ -23,10 +184,36 @@ void PrintUsage(const char* name) {
               << "Options:\n"
               << "  -m, --model <path>      Path to ONNX model file (Required)\n"
               << "  -t, --threads <num>     Number of threads (Default: 1)\n"
+              << "  --processes <num>       Run <num> single-threaded worker processes instead of threads\n"
               << "  -n, --requests <num>    Total number of requests (Default: 100)\n"
               << "  -w, --warmup <num>      Warmup rounds (Default: 10)\n"
               << "  -l, --memory_limit <MB> Memory Limit in MB (Default: 0, no limit)\n"
               << "  -o, --optimization <lvl> Optimization level: basic, all, none (Default: all)\n"
+              << "  --allocator <mode>      CPU allocator: session, shared, tracking (Default: session)\n"
+              << "  --no_mem_pattern        Disable ORT memory pattern optimization\n"
+              << "  --no_cpu_arena          Disable the per-session CPU arena (session allocator only)\n"
+              << "  --arena_extend <s>      Shared arena extend strategy: pow2, requested\n"
+              << "  --arena_initial_chunk <bytes> Shared arena initial chunk size\n"
+              << "  --arena_max_mem <MB>    Shared arena memory cap (Default: 0, unlimited)\n"
+              << "  --cgroup_watchdog       Enable cgroup v2 / PSI event-driven memory watchdog\n"
+              << "  --watchdog_action <act> Watchdog action: stop, shrink, abort (Default: stop)\n"
+              << "  --cgroup_memory_ratio <r> Trigger when memory.current >= r * memory.max (Default: 0.9)\n"
+              << "  --psi_stall_us <us>     PSI trigger: memory stall per 1s window (Default: 0, off)\n"
+              << "  --trace <path>          Record per-request spans and save as Chrome/Perfetto trace JSON\n"
+              << "  --trace_capacity <num>  Max spans kept per thread (Default: 100000)\n"
+              << "  --request_log <path>    Stream per-request binary log (read with inferbench_log)\n"
+              << "  --deadline_ms <ms>      Per-request deadline; reject/cancel requests that cannot meet it (Default: 0, off)\n"
+              << "  --arrival_rate <qps>    Open-loop Poisson arrivals at <qps> instead of closed loop (Default: 0)\n"
+              << "  --serve <endpoint>      End-to-end mode via local server: tcp:<host>:<port> or unix:<path>\n"
+              << "  --server_workers <num>  Server worker threads in --serve mode (Default: same as --threads)\n"
+              << "  --roofline              Report achieved GFLOP/s and bandwidth against measured machine peak\n"
+              << "  --null_engine <us>      Benchmark a no-op engine that spins <us> per request instead of a model\n"
+              << "  --harness_calibration <num> Null-engine requests used to measure harness overhead, capped at --requests (Default: 20000, 0: off; not in --serve/--processes)\n"
+              << "  --cold_start <reps>     Cold-start mode: reload the model <reps> times, record load and first requests\n"
+              << "  --cold_requests <num>   Requests recorded per cold-start / recovery phase (Default: 20)\n"
+              << "  --idle_ms <ms>          Cold-start mode: idle gap before the recovery phase (Default: 0)\n"
+              << "  --flush_cache           Cold-start mode: sweep a large buffer before the recovery phase\n"
+              << "  --evict_pages           Cold-start mode: drop the model file page cache and page out anonymous memory\n"
               << "  --probe                 Print model metadata and exit\n"
               << "  -j, --json <path>       Save report to JSON file\n"
               << "  -h, --help              Show this help message\n";
@@ -38,7 +225,14 @@ int main(int argc, char** argv) {
     std::string json_path;
     std::string opt_str = "all";
     bool probe_mode = false;
+    bool roofline_mode = false;
+    std::string serve_endpoint;
+    int server_workers = 0;
+    double null_engine_us = -1.0; // < 0 表示使用 ONNX 模型
     BenchmarkConfig config;
+    ColdStartConfig cold_config;
+    cold_config.repetitions = 0; // 0 表示不进入冷启动模式
+    MemoryOptions memory_options;
 
     // 解析命令行参数
     struct option long_options[] = {
@@ -48,6 +242,32 @@ int main(int argc, char** argv) {
         {"warmup", required_argument, 0, 'w'},
         {"memory_limit", required_argument, 0, 'l'},
         {"optimization", required_argument, 0, 'o'},
+        {"cgroup_watchdog", no_argument, 0, kOptCgroupWatchdog},
+        {"watchdog_action", required_argument, 0, kOptWatchdogAction},
+        {"cgroup_memory_ratio", required_argument, 0, kOptCgroupMemoryRatio},
+        {"psi_stall_us", required_argument, 0, kOptPsiStallUs},
+        {"trace", required_argument, 0, kOptTrace},
+        {"trace_capacity", required_argument, 0, kOptTraceCapacity},
+        {"request_log", required_argument, 0, kOptRequestLog},
+        {"processes", required_argument, 0, kOptProcesses},
+        {"allocator", required_argument, 0, kOptAllocator},
+        {"no_mem_pattern", no_argument, 0, kOptNoMemPattern},
+        {"no_cpu_arena", no_argument, 0, kOptNoCpuArena},
+        {"arena_extend", required_argument, 0, kOptArenaExtend},
+        {"arena_initial_chunk", required_argument, 0, kOptArenaInitialChunk},
+        {"arena_max_mem", required_argument, 0, kOptArenaMaxMem},
+        {"deadline_ms", required_argument, 0, kOptDeadlineMs},
+        {"arrival_rate", required_argument, 0, kOptArrivalRate},
+        {"serve", required_argument, 0, kOptServe},
+        {"server_workers", required_argument, 0, kOptServerWorkers},
+        {"roofline", no_argument, 0, kOptRoofline},
+        {"null_engine", required_argument, 0, kOptNullEngine},
+        {"harness_calibration", required_argument, 0, kOptHarnessCalibration},
+        {"cold_start", required_argument, 0, kOptColdStart},
+        {"cold_requests", required_argument, 0, kOptColdRequests},
+        {"idle_ms", required_argument, 0, kOptIdleMs},
+        {"flush_cache", no_argument, 0, kOptFlushCache},
+        {"evict_pages", no_argument, 0, kOptEvictPages},
         {"probe", no_argument, 0, 'p'},
         {"json", required_argument, 0, 'j'},
         {"help", no_argument, 0, 'h'},
@@ -66,23 +286,89 @@ int main(int argc, char** argv) {
             case 'o': opt_str = optarg; break;
             case 'p': probe_mode = true; break;
             case 'j': json_path = optarg; break;
+            case kOptCgroupWatchdog: config.cgroup_watchdog = true; break;
+            case kOptWatchdogAction:
+                if (!ParseWatchdogAction(optarg, config.watchdog_action)) {
+                    std::cerr << "Error: Unknown watchdog action '" << optarg << "'.\n";
+                    return 1;
+                }
+                break;
+            case kOptCgroupMemoryRatio: config.watchdog.memory_ratio = std::stod(optarg); break;
+            case kOptPsiStallUs: config.watchdog.psi_stall_us = std::stoi(optarg); break;
+            case kOptTrace: config.trace_path = optarg; break;
+            case kOptTraceCapacity: config.trace_capacity = std::stoul(optarg); break;
+            case kOptRequestLog: config.request_log_path = optarg; break;
+            case kOptProcesses: config.processes = std::stoi(optarg); break;
+            case kOptAllocator:
+                if (!ParseAllocatorMode(optarg, memory_options.allocator)) {
+                    std::cerr << "Error: Unknown allocator '" << optarg << "'.\n";
+                    return 1;
+                }
+                break;
+            case kOptNoMemPattern: memory_options.enable_mem_pattern = false; break;
+            case kOptNoCpuArena: memory_options.enable_cpu_mem_arena = false; break;
+            case kOptArenaExtend:
+                if (std::string(optarg) == "pow2") memory_options.arena_extend_strategy = 0;
+                else if (std::string(optarg) == "requested") memory_options.arena_extend_strategy = 1;
+                else {
+                    std::cerr << "Error: Unknown arena extend strategy '" << optarg << "'.\n";
+                    return 1;
+                }
+                break;
+            case kOptArenaInitialChunk: memory_options.arena_initial_chunk_bytes = std::stoi(optarg); break;
+            case kOptArenaMaxMem:
+                memory_options.arena_max_mem_bytes = static_cast<size_t>(std::stod(optarg) * 1024 * 1024);
+                break;
+            case kOptDeadlineMs: config.deadline_ms = std::stod(optarg); break;
+            case kOptArrivalRate: config.arrival_rate = std::stod(optarg); break;
+            case kOptRoofline: roofline_mode = true; break;
+            case kOptNullEngine: null_engine_us = std::stod(optarg); break;
+            case kOptHarnessCalibration: config.harness_calibration_requests = std::stoi(optarg); break;
+            case kOptColdStart: cold_config.repetitions = std::stoi(optarg); break;
+            case kOptColdRequests: cold_config.first_requests = std::stoi(optarg); break;
+            case kOptIdleMs: cold_config.idle_ms = std::stoi(optarg); break;
+            case kOptFlushCache: cold_config.flush_cache = true; break;
+            case kOptEvictPages: cold_config.evict_pages = true; break;
+            case kOptServe: serve_endpoint = optarg; break;
+            case kOptServerWorkers: server_workers = std::stoi(optarg); break;
             case 'h': PrintUsage(argv[0]); return 0;
             default: PrintUsage(argv[0]); return 1;
         }
     }
 
     // 校验必填参数
-    if (model_path.empty()) {
+    const bool null_engine_mode = null_engine_us >= 0;
+    if (model_path.empty() && !null_engine_mode) {
         std::cerr << "Error: --model argument is required.\n";
         PrintUsage(argv[0]);
         return 1;
     }
+    if (null_engine_mode && (config.processes > 0 || probe_mode || roofline_mode)) {
+        std::cerr << "Error: --null_engine cannot be combined with --processes, --probe or --roofline.\n";
+        return 1;
+    }
+    const bool cold_start_mode = cold_config.repetitions > 0;
+    if (cold_start_mode && (config.processes > 0 || probe_mode || roofline_mode || !serve_endpoint.empty())) {
+        std::cerr << "Error: --cold_start cannot be combined with --processes, --probe, --roofline or --serve.\n";
+        return 1;
+    }
+    if (null_engine_mode) {
+        model_path = "null_engine";
+    }
+    if (!serve_endpoint.empty() && config.processes > 0) {
+        std::cerr << "Error: --serve cannot be combined with --processes.\n";
+        return 1;
+    }
 
     std::cout << "========================================" << std::endl;
     std::cout << " InferBench-Linux v0.1.0 (MVP) " << std::endl;
     std::cout << "========================================" << std::endl;
     std::cout << "Model: " << model_path << std::endl;
-    std::cout << "Threads: " << config.threads << std::endl;
+    if (config.processes > 0) {
+        std::cout << "Processes: " << config.processes << std::endl;
+    } else {
+        std::cout << "Threads: " << config.threads << std::endl;
+    }
     std::cout << "Requests: " << config.requests << std::endl;
     std::cout << "Warmup: " << config.warmup_rounds << std::endl;
     std::cout << "----------------------------------------" << std::endl;
@@ -91,11 +377,7 @@ int main(int argc, char** argv) {
         // 1. 初始化模块
         std::cout << "[Init] Initializing Modules..." << std::endl;
         SystemMonitor monitor;
-        InferenceEngine engine;
 
-        // 2. 加载模型
-        std::cout << "[Init] Loading Model..." << std::endl;
-        
         int opt_level = 99; // Default all
         if (opt_str == "basic") opt_level = 1;
         else if (opt_str == "none") opt_level = 0;
@@ -104,18 +386,121 @@ int main(int argc, char** argv) {
             std::cerr << "Warning: Unknown optimization level '" << opt_str << "', using 'all'." << std::endl;
         }
 
-        engine.LoadModel(model_path, opt_level);
+        if (cold_start_mode) {
+            // 冷启动模式：每次重复重新加载模型，单线程记录加载耗时与前 N 个请求
+            ColdStartRunner::EngineFactory factory = [&]() -> std::unique_ptr<Engine> {
+                if (null_engine_mode) {
+                    return std::make_unique<NullEngine>(kNullEngineInputSize, static_cast<int64_t>(null_engine_us * 1000.0));
+                }
+                auto ort_engine = std::make_unique<InferenceEngine>();
+                ort_engine->LoadModel(model_path, opt_level, memory_options);
+                return ort_engine;
+            };
+            std::cout << "[Run] Starting Cold-Start Benchmark (" << cold_config.repetitions << " repetitions, "
+                      << cold_config.first_requests << " requests each)..." << std::endl;
+            ColdStartRunner runner(factory, null_engine_mode ? "" : model_path);
+            ColdStartResult cold = runner.Run(cold_config);
 
-        // 如果是 Probe 模式，打印信息后退出
-        if (probe_mode) {
-           PrintModelInfo(engine);
-           return 0;
+            std::cout << "----------------------------------------" << std::endl;
+            std::cout << " Cold-Start Results " << std::endl;
+            std::cout << "----------------------------------------" << std::endl;
+            PrintColdStartReport(cold_config, cold);
+            std::cout << "========================================" << std::endl;
+            if (!json_path.empty()) SaveColdStartJson(json_path, model_path, cold_config, cold);
+            return 0;
         }
 
-        // 3. 执行压测
-        std::cout << "[Run] Starting Benchmark..." << std::endl;
-        BenchmarkRunner runner(engine, monitor);
-        BenchmarkResult result = runner.Run(config);
+        BenchmarkResult result;
+        ServingResult serving;
+        if (config.processes > 0 && !probe_mode) {
+            // 多进程模式：协调者不创建 ONNX Runtime 对象，由每个 Worker 进程各自加载模型
+            if (!config.trace_path.empty() || !config.request_log_path.empty() || config.cgroup_watchdog ||
+                config.deadline_ms > 0 || config.arrival_rate > 0) {
+                std::cerr << "Warning: --trace, --request_log, --cgroup_watchdog, --deadline_ms and --arrival_rate are ignored with --processes." << std::endl;
+            }
+            std::cout << "[Run] Starting Benchmark (" << config.processes << " processes)..." << std::endl;
+            ProcessRunner runner(model_path, opt_level, monitor, memory_options);
+            result = runner.Run(config);
+        } else {
+            std::unique_ptr<Engine> engine_holder;
+            if (null_engine_mode) {
+                // 空引擎：不加载模型，用于测量压测框架与服务端链路本身的开销
+                engine_holder = std::make_unique<NullEngine>(kNullEngineInputSize, static_cast<int64_t>(null_engine_us * 1000.0));
+            } else {
+                auto ort_engine = std::make_unique<InferenceEngine>();
+
+                // 2. 加载模型
+                std::cout << "[Init] Loading Model..." << std::endl;
+                ort_engine->LoadModel(model_path, opt_level, memory_options);
+
+                // 如果是 Probe 模式，打印信息后退出
+                if (probe_mode) {
+                   PrintModelInfo(*ort_engine, model_path);
+                   return 0;
+                }
+                engine_holder = std::move(ort_engine);
+            }
+            Engine& engine = *engine_holder;
+
+            if (!serve_endpoint.empty()) {
+                // 3a. 端到端模式：本地服务 + 内置客户端，threads 为客户端连接数
+                if (!config.trace_path.empty() || !config.request_log_path.empty() || config.cgroup_watchdog ||
+                    config.memory_limit_mb > 0 || config.deadline_ms > 0 || config.arrival_rate > 0) {
+                    std::cerr << "Warning: --trace, --request_log, --memory_limit, --cgroup_watchdog, --deadline_ms and --arrival_rate are ignored with --serve." << std::endl;
+                }
+                InferenceServer server(engine);
+                server.Start(serve_endpoint, server_workers > 0 ? server_workers : config.threads);
+                std::cout << "[Run] Serving on " << server.GetEndpoint() << ", starting load client..." << std::endl;
+
+                LoadClient client(server.GetEndpoint());
+                monitor.GetCpuUsage(); // 建立 CPU 基线，压测结束时读取整段平均值
+                // 与 BenchmarkRunner 相同，压测期间每 100ms 采样一次 RSS 取峰值
+                std::atomic<bool> sampling(true);
+                double peak_rss_mb = monitor.GetMemoryUsage();
+                std::thread rss_sampler([&]() {
+                    while (sampling) {
+                        peak_rss_mb = std::max(peak_rss_mb, monitor.GetMemoryUsage());
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    }
+                });
+                try {
+                    serving = client.Run(config, engine.GetInputSize());
+                } catch (...) {
+                    sampling = false;
+                    rss_sampler.join();
+                    throw;
+                }
+                sampling = false;
+                rss_sampler.join();
+                result.avg_cpu_usage = monitor.GetCpuUsage();
+                result.peak_memory_mb = std::max(peak_rss_mb, monitor.GetMemoryUsage());
+                server.Stop();
+
+                result.qps = serving.qps;
+                result.avg_latency_ms = serving.e2e_avg_ms;
+                result.p99_latency_ms = serving.e2e_p99_ms;
+                result.completed_requests = serving.completed_requests;
+                result.failed_requests = serving.failed_requests;
+                result.final_concurrency = config.threads;
+            } else {
+                // 3. 执行压测
+                std::cout << "[Run] Starting Benchmark..." << std::endl;
+                BenchmarkRunner runner(engine, monitor);
+                result = runner.Run(config);
+            }
+        }
+
+        // Roofline：静态开销 + 实测机器峰值 + 实测吞吐
+        ModelCost model_cost;
+        MachinePeak machine_peak;
+        RooflineReport roofline;
+        if (roofline_mode) {
+            int concurrency = config.processes > 0 ? config.processes : config.threads;
+            std::cout << "[Roofline] Analyzing model and measuring machine peak (" << concurrency << " threads)..." << std::endl;
+            model_cost = ModelAnalyzer::Analyze(model_path);
+            machine_peak = Roofline::MeasureMachinePeak(concurrency);
+            roofline = Roofline::BuildReport(model_cost, machine_peak, result.qps);
+        }
 
         // 4. 输出报告
         std::cout << "----------------------------------------" << std::endl;
@@ -127,6 +512,79 @@ int main(int argc, char** argv) {
         std::cout << "P99 Latency:    " << result.p99_latency_ms << " ms" << std::endl;
         std::cout << "Avg CPU Usage:  " << result.avg_cpu_usage << " %" << std::endl;
         std::cout << "Peak Memory:    " << result.peak_memory_mb << " MB" << std::endl;
+        if (!serve_endpoint.empty()) {
+            std::cout << "  Network:      " << serving.network_avg_ms << " ms avg" << std::endl;
+            std::cout << "  Queue:        " << serving.queue_avg_ms << " ms avg, " << serving.queue_p99_ms << " ms P99" << std::endl;
+            std::cout << "  Inference:    " << serving.infer_avg_ms << " ms avg, " << serving.infer_p99_ms << " ms P99" << std::endl;
+        }
+        if (config.deadline_ms > 0) {
+            std::cout << "Goodput:        " << result.goodput_qps << " QPS (within " << config.deadline_ms << " ms)" << std::endl;
+            std::cout << "Rejected:       " << result.rejected_requests << " (" << result.rejection_rate * 100.0 << " %)" << std::endl;
+            std::cout << "Timed Out:      " << result.timeout_requests << " (" << result.timeout_rate * 100.0 << " %)" << std::endl;
+        }
+        if (config.arrival_rate > 0) {
+            std::cout << "Avg Queue:      " << result.avg_queue_ms << " ms" << std::endl;
+        }
+        if (result.session_memory_mb > 0 || result.arena_peak_mb > 0) {
+            std::cout << "Session Memory: " << result.session_memory_mb << " MB" << std::endl;
+            std::cout << "Arena Peak:     " << result.arena_peak_mb << " MB"
+                      << (result.arena_peak_approximate ? " (approx., malloc heap high-water mark)" : "") << std::endl;
+        }
+        if (result.alloc_per_inference_kb > 0) {
+            std::cout << "Alloc/Infer:    " << result.alloc_per_inference_kb << " KB" << std::endl;
+        }
+        if (result.failed_requests > 0) {
+            std::cout << "Failed:         " << result.failed_requests << std::endl;
+        }
+        if (result.completed_requests != config.requests) {
+            std::cout << "Completed:      " << result.completed_requests << " / " << config.requests << std::endl;
+        }
+        if (result.watchdog_triggers > 0) {
+            std::cout << "Watchdog:       " << result.watchdog_triggers << " trigger(s), final concurrency "
+                      << result.final_concurrency << (result.aborted ? " (aborted)" : "") << std::endl;
+        }
+        if (result.harness_request_us > 0) {
+            std::cout << "Harness:        " << result.harness_request_us << " us/request ("
+                      << result.harness_overhead_pct << " % of avg latency), "
+                      << result.harness_latency_us << " us timer bias per sample" << std::endl;
+        } else if (!serve_endpoint.empty() || config.processes > 0) {
+            std::cout << "Harness:        not measured (calibration only runs in thread mode)" << std::endl;
+        }
+        if (result.energy_available) {
+            std::cout << "Energy:         " << result.energy_joules << " J (" << result.avg_power_watts << " W avg, "
+                      << result.joules_per_inference * 1000.0 << " mJ/inference, "
+                      << result.queries_per_joule << " queries/J)" << std::endl;
+        }
+        if (result.freq_available) {
+            std::cout << "CPU Frequency:  " << result.avg_freq_mhz << " MHz avg, " << result.min_freq_mhz << " MHz min";
+            if (result.below_base_events > 0) std::cout << ", " << result.below_base_events << " drop(s) below base";
+            std::cout << std::endl;
+        }
+        if (result.throttle_events > 0) {
+            std::cout << "Throttling:     " << result.throttle_events << " thermal throttle event(s)" << std::endl;
+        }
+        if (result.cgroup_available) {
+            std::cout << "Cgroup Memory:  " << result.cgroup_peak_memory_mb << " MB peak";
+            if (result.cgroup_memory_max_mb > 0) std::cout << " / " << result.cgroup_memory_max_mb << " MB max";
+            std::cout << std::endl;
+            std::cout << "CPU Throttled:  " << result.cpu_throttled_ms << " ms ("
+                      << result.cpu_throttled_ratio * 100.0 << " % of periods";
+            if (result.cpu_quota_cores > 0) std::cout << ", quota " << result.cpu_quota_cores << " cores";
+            std::cout << ")" << std::endl;
+        }
+        if (roofline_mode) {
+            std::cout << "----------------------------------------" << std::endl;
+            std::cout << " Roofline " << std::endl;
+            std::cout << "----------------------------------------" << std::endl;
+            PrintModelCost(model_cost);
+            std::cout << "  Machine Peak:         " << machine_peak.peak_gflops << " GFLOP/s, "
+                      << machine_peak.peak_bandwidth_gbs << " GB/s (ridge " << roofline.ridge_point << " FLOP/Byte)\n";
+            std::cout << "  Achieved:             " << roofline.achieved_gflops << " GFLOP/s, "
+                      << roofline.achieved_bandwidth_gbs << " GB/s\n";
+            std::cout << "  Roofline Bound:       " << roofline.attainable_gflops << " GFLOP/s ("
+                      << (roofline.memory_bound ? "memory-bound" : "compute-bound") << ")\n";
+            std::cout << "  Efficiency:           " << roofline.efficiency * 100.0 << " % of roofline" << std::endl;
+        }
         std::cout << "========================================" << std::endl;
 
         // 5. 保存 JSON
@@ -137,14 +595,92 @@ int main(int argc, char** argv) {
                 json_file << "  \"model\": \"" << model_path << "\",\n";
                 json_file << "  \"config\": {\n";
                 json_file << "    \"threads\": " << config.threads << ",\n";
-                json_file << "    \"requests\": " << config.requests << "\n";
+                json_file << "    \"processes\": " << config.processes << ",\n";
+                json_file << "    \"requests\": " << config.requests << ",\n";
+                json_file << "    \"deadline_ms\": " << config.deadline_ms << ",\n";
+                json_file << "    \"arrival_rate\": " << config.arrival_rate << "\n";
                 json_file << "  },\n";
                 json_file << "  \"result\": {\n";
                 json_file << "    \"qps\": " << result.qps << ",\n";
                 json_file << "    \"avg_latency_ms\": " << result.avg_latency_ms << ",\n";
                 json_file << "    \"p99_latency_ms\": " << result.p99_latency_ms << ",\n";
                 json_file << "    \"avg_cpu_usage\": " << result.avg_cpu_usage << ",\n";
-                json_file << "    \"peak_memory_mb\": " << result.peak_memory_mb << "\n";
+                json_file << "    \"peak_memory_mb\": " << result.peak_memory_mb << ",\n";
+                json_file << "    \"completed_requests\": " << result.completed_requests << ",\n";
+                json_file << "    \"failed_requests\": " << result.failed_requests << ",\n";
+                json_file << "    \"watchdog_triggers\": " << result.watchdog_triggers << ",\n";
+                json_file << "    \"aborted\": " << (result.aborted ? "true" : "false") << ",\n";
+                json_file << "    \"final_concurrency\": " << result.final_concurrency << ",\n";
+                json_file << "    \"goodput_qps\": " << result.goodput_qps << ",\n";
+                json_file << "    \"rejected_requests\": " << result.rejected_requests << ",\n";
+                json_file << "    \"timeout_requests\": " << result.timeout_requests << ",\n";
+                json_file << "    \"rejection_rate\": " << result.rejection_rate << ",\n";
+                json_file << "    \"timeout_rate\": " << result.timeout_rate << ",\n";
+                json_file << "    \"avg_queue_ms\": " << result.avg_queue_ms << ",\n";
+                json_file << "    \"memory\": {\n";
+                json_file << "      \"session_memory_mb\": " << result.session_memory_mb << ",\n";
+                json_file << "      \"arena_peak_mb\": " << result.arena_peak_mb << ",\n";
+                json_file << "      \"arena_peak_approximate\": " << (result.arena_peak_approximate ? "true" : "false") << ",\n";
+                json_file << "      \"alloc_per_inference_kb\": " << result.alloc_per_inference_kb << "\n";
+                json_file << "    },\n";
+                json_file << "    \"harness\": {\n";
+                json_file << "      \"measured\": " << (result.harness_request_us > 0 ? "true" : "false") << ",\n";
+                json_file << "      \"latency_us\": " << result.harness_latency_us << ",\n";
+                json_file << "      \"request_us\": " << result.harness_request_us << ",\n";
+                json_file << "      \"overhead_pct\": " << result.harness_overhead_pct << "\n";
+                json_file << "    },\n";
+                json_file << "    \"power\": {\n";
+                json_file << "      \"energy_available\": " << (result.energy_available ? "true" : "false") << ",\n";
+                json_file << "      \"energy_joules\": " << result.energy_joules << ",\n";
+                json_file << "      \"avg_power_watts\": " << result.avg_power_watts << ",\n";
+                json_file << "      \"joules_per_inference\": " << result.joules_per_inference << ",\n";
+                json_file << "      \"queries_per_joule\": " << result.queries_per_joule << ",\n";
+                json_file << "      \"freq_available\": " << (result.freq_available ? "true" : "false") << ",\n";
+                json_file << "      \"avg_freq_mhz\": " << result.avg_freq_mhz << ",\n";
+                json_file << "      \"min_freq_mhz\": " << result.min_freq_mhz << ",\n";
+                json_file << "      \"throttle_events\": " << result.throttle_events << ",\n";
+                json_file << "      \"below_base_events\": " << result.below_base_events << "\n";
+                json_file << "    },\n";
+                json_file << "    \"cgroup\": {\n";
+                json_file << "      \"available\": " << (result.cgroup_available ? "true" : "false") << ",\n";
+                json_file << "      \"peak_memory_mb\": " << result.cgroup_peak_memory_mb << ",\n";
+                json_file << "      \"memory_max_mb\": " << result.cgroup_memory_max_mb << ",\n";
+                json_file << "      \"oom_events\": " << result.cgroup_oom_events << ",\n";
+                json_file << "      \"cpu_quota_cores\": " << result.cpu_quota_cores << ",\n";
+                json_file << "      \"cpu_nr_throttled\": " << result.cpu_nr_throttled << ",\n";
+                json_file << "      \"cpu_throttled_ms\": " << result.cpu_throttled_ms << ",\n";
+                json_file << "      \"cpu_throttled_ratio\": " << result.cpu_throttled_ratio << "\n";
+                json_file << "    }" << (serve_endpoint.empty() && !roofline_mode ? "\n" : ",\n");
+                if (!serve_endpoint.empty()) {
+                    json_file << "    \"serving\": {\n";
+                    json_file << "      \"endpoint\": \"" << serve_endpoint << "\",\n";
+                    json_file << "      \"e2e_avg_ms\": " << serving.e2e_avg_ms << ",\n";
+                    json_file << "      \"e2e_p99_ms\": " << serving.e2e_p99_ms << ",\n";
+                    json_file << "      \"network_avg_ms\": " << serving.network_avg_ms << ",\n";
+                    json_file << "      \"queue_avg_ms\": " << serving.queue_avg_ms << ",\n";
+                    json_file << "      \"queue_p99_ms\": " << serving.queue_p99_ms << ",\n";
+                    json_file << "      \"infer_avg_ms\": " << serving.infer_avg_ms << ",\n";
+                    json_file << "      \"infer_p99_ms\": " << serving.infer_p99_ms << "\n";
+                    json_file << "    }" << (roofline_mode ? ",\n" : "\n");
+                }
+                if (roofline_mode) {
+                    json_file << "    \"roofline\": {\n";
+                    json_file << "      \"flops_per_inference\": " << model_cost.flops << ",\n";
+                    json_file << "      \"bytes_per_inference\": " << model_cost.bytes << ",\n";
+                    json_file << "      \"parameter_count\": " << model_cost.parameter_count << ",\n";
+                    json_file << "      \"peak_activation_mb\": " << model_cost.peak_activation_bytes / (1024.0 * 1024.0) << ",\n";
+                    json_file << "      \"unanalyzed_nodes\": " << model_cost.unanalyzed_nodes << ",\n";
+                    json_file << "      \"arithmetic_intensity\": " << roofline.arithmetic_intensity << ",\n";
+                    json_file << "      \"peak_gflops\": " << machine_peak.peak_gflops << ",\n";
+                    json_file << "      \"peak_bandwidth_gbs\": " << machine_peak.peak_bandwidth_gbs << ",\n";
+                    json_file << "      \"ridge_point\": " << roofline.ridge_point << ",\n";
+                    json_file << "      \"achieved_gflops\": " << roofline.achieved_gflops << ",\n";
+                    json_file << "      \"achieved_bandwidth_gbs\": " << roofline.achieved_bandwidth_gbs << ",\n";
+                    json_file << "      \"attainable_gflops\": " << roofline.attainable_gflops << ",\n";
+                    json_file << "      \"efficiency\": " << roofline.efficiency << ",\n";
+                    json_file << "      \"memory_bound\": " << (roofline.memory_bound ? "true" : "false") << "\n";
+                    json_file << "    }\n";
+                }
                 json_file << "  }\n";
                 json_file << "}\n";
                 std::cout << "[Report] Saved to " << json_path << std::endl;
@@ -153,6 +689,11 @@ int main(int argc, char** argv) {
             }
         }
 
+        // 看门狗中止时以非零状态退出，便于脚本识别
+        if (result.aborted) {
+            return 2;
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "\n[Fatal Error] " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+/**
+ * @brief 测试辅助类：在临时目录中伪造 cgroup / sysfs 等内核接口文件，析构时整体删除
+ */
+class FakeFileTree {
+public:
+    /**
+     * @param prefix 临时目录名前缀 (位于 /tmp 下)
+     */
+    explicit FakeFileTree(const std::string& prefix) {
+        std::string tmpl = "/tmp/" + prefix + "_XXXXXX";
+        dir_ = mkdtemp(&tmpl[0]) != nullptr ? tmpl : std::string();
+    }
+    virtual ~FakeFileTree() {
+        std::error_code ec;
+        if (!dir_.empty()) std::filesystem::remove_all(dir_, ec);
+    }
+
+    FakeFileTree(const FakeFileTree&) = delete;
+    FakeFileTree& operator=(const FakeFileTree&) = delete;
+
+    /**
+     * @brief 写入 relative 路径的文件，自动创建中间目录
+     */
+    void Write(const std::string& relative, const std::string& content) {
+        std::filesystem::path path = std::filesystem::path(dir_) / relative;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << content;
+    }
+
+    const std::string& Path() const { return dir_; }
+
+private:
+    std::string dir_;
+};
@@ -1,7 +1,45 @@
 #include <gtest/gtest.h>
 #include "BenchmarkRunner.h"
+#include "InferenceEngine.h"
+#include "NullEngine.h"
+#include "RequestLog.h"
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace {
+
+// 前 slow_runs 次推理忙等 slow_ns，之后忙等 fast_ns：模拟预热阶段明显慢于稳态的引擎
+class SlowStartEngine : public Engine {
+public:
+    SlowStartEngine(int slow_runs, int64_t slow_ns, int64_t fast_ns)
+        : slow_runs_(slow_runs), slow_ns_(slow_ns), fast_ns_(fast_ns) {}
+
+    std::vector<float> Run(const std::vector<float>&) override {
+        int64_t spin_ns = runs_.fetch_add(1) < slow_runs_ ? slow_ns_ : fast_ns_;
+        auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(spin_ns);
+        while (std::chrono::steady_clock::now() < end) {
+        }
+        return std::vector<float>(1);
+    }
+    std::vector<float> Run(const std::vector<float>& input_data, CancelToken&) override {
+        return Run(input_data);
+    }
+    int64_t GetInputSize() const override { return 16; }
+
+private:
+    std::atomic<int> runs_{0};
+    int slow_runs_;
+    int64_t slow_ns_;
+    int64_t fast_ns_;
+};
+
+} // namespace
 
 // 这个测试会真正跑起来，虽然是用随机数据。
 // 它验证了所有模块的协同工作。
@@ -41,3 +79,256 @@ TEST(BenchmarkRunnerTest, Integration) {
     // 注意：在短测试里，CPU 采样可能会错过峰值或为 0，所以很难断言 > 0，但不应崩坏
     EXPECT_GE(result.peak_memory_mb, 0.0);
 }
+
+// 截止时间远小于单次推理耗时：除了周期性的探测请求 (会超时) 外全部被拒绝
+TEST(BenchmarkRunnerTest, DeadlineRejectsUnreachableRequests) {
+    std::string model_path = "tests/resnet50.onnx";
+    std::ifstream f(model_path.c_str());
+    if (!f.good()) {
+        GTEST_SKIP() << "Skipping integration test: model not found";
+    }
+
+    SystemMonitor monitor;
+    InferenceEngine engine;
+    ASSERT_NO_THROW(engine.LoadModel(model_path));
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 20;
+    config.warmup_rounds = 2;
+    config.deadline_ms = 0.01;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_GE(result.rejected_requests, 18);
+    EXPECT_EQ(result.rejected_requests + result.timeout_requests, 20);
+    EXPECT_GT(result.rejection_rate, 0.85);
+    EXPECT_DOUBLE_EQ(result.goodput_qps, 0.0);
+}
+
+// 宽松的截止时间 + 低到达速率：所有请求都应在截止时间内完成
+TEST(BenchmarkRunnerTest, OpenLoopGoodputWithinDeadline) {
+    std::string model_path = "tests/resnet50.onnx";
+    std::ifstream f(model_path.c_str());
+    if (!f.good()) {
+        GTEST_SKIP() << "Skipping integration test: model not found";
+    }
+
+    SystemMonitor monitor;
+    InferenceEngine engine;
+    ASSERT_NO_THROW(engine.LoadModel(model_path));
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 10;
+    config.warmup_rounds = 2;
+    config.deadline_ms = 10000.0;
+    config.arrival_rate = 20.0;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_EQ(result.completed_requests, 10);
+    EXPECT_EQ(result.rejected_requests, 0);
+    EXPECT_EQ(result.timeout_requests, 0);
+    EXPECT_GT(result.goodput_qps, 0.0);
+    EXPECT_DOUBLE_EQ(result.goodput_qps, result.qps);
+}
+
+// 空引擎不依赖模型文件：验证调度逻辑本身，并标定框架开销
+TEST(BenchmarkRunnerTest, NullEngineReportsHarnessOverhead) {
+    SystemMonitor monitor;
+    NullEngine engine(16, 200 * 1000); // 每次推理忙等 200us
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 500;
+    config.warmup_rounds = 2;
+    config.harness_calibration_requests = 2000;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_EQ(result.completed_requests, 500);
+    EXPECT_EQ(result.failed_requests, 0);
+    EXPECT_GE(result.avg_latency_ms, 0.2);
+    EXPECT_GT(result.harness_request_us, 0.0);
+    EXPECT_GE(result.harness_latency_us, 0.0);
+    EXPECT_LT(result.harness_latency_us, 200.0);
+    EXPECT_GT(result.harness_overhead_pct, 0.0);
+}
+
+// 标定沿用 Trace 与请求日志配置，但不能覆盖主压测的输出，也不留下临时文件
+TEST(BenchmarkRunnerTest, HarnessCalibrationUsesScratchSinks) {
+    SystemMonitor monitor;
+    NullEngine engine(16);
+
+    BenchmarkConfig config;
+    config.requests = 100;
+    config.harness_calibration_requests = 20000;
+    config.trace_path = "benchmark_calibration_trace.json";
+    config.request_log_path = "benchmark_calibration.reqlog";
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+    EXPECT_GT(result.harness_request_us, 0.0);
+
+    RequestLogReader reader;
+    reader.Open(config.request_log_path);
+    EXPECT_EQ(reader.size(), 100u);
+    std::ifstream trace(config.trace_path);
+    EXPECT_TRUE(trace.good());
+    std::ifstream scratch(config.request_log_path + ".calibration");
+    EXPECT_FALSE(scratch.good());
+
+    std::remove(config.trace_path.c_str());
+    std::remove(config.request_log_path.c_str());
+}
+
+// 内存持续超限：收缩并发后仍超限，看门狗应在冷却后再次收缩，直到单线程
+TEST(BenchmarkRunnerTest, RssWatchdogKeepsShrinkingWhileOverLimit) {
+    SystemMonitor monitor;
+    NullEngine engine(16, 1000 * 1000); // 1ms
+
+    BenchmarkConfig config;
+    config.threads = 4;
+    config.requests = 2500;
+    config.warmup_rounds = 0;
+    config.memory_limit_mb = 1; // 进程 RSS 必然超过 1MB
+    config.watchdog_action = WatchdogAction::kShrinkConcurrency;
+    config.harness_calibration_requests = 0;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_GE(result.watchdog_triggers, 2);
+    EXPECT_EQ(result.final_concurrency, 1);
+    EXPECT_EQ(result.completed_requests, 2500);
+    EXPECT_FALSE(result.aborted);
+}
+
+// 堆高水位估算的 arena 峰值不应包含框架自身的 Trace 环形缓冲区
+TEST(BenchmarkRunnerTest, ArenaPeakExcludesHarnessBuffers) {
+    SystemMonitor monitor;
+    NullEngine engine(16, 100 * 1000);
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 2000;
+    config.warmup_rounds = 2;
+    config.harness_calibration_requests = 0;
+    config.trace_path = "benchmark_arena_trace.json";
+    config.trace_capacity = 200000; // 每个 Worker 数十 MB
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+    std::remove(config.trace_path.c_str());
+
+    EXPECT_TRUE(result.arena_peak_approximate);
+    EXPECT_LT(result.arena_peak_mb, 4.0);
+}
+
+TEST(BenchmarkRunnerTest, HarnessCalibrationCanBeDisabled) {
+    SystemMonitor monitor;
+    NullEngine engine(16);
+
+    BenchmarkConfig config;
+    config.requests = 10;
+    config.harness_calibration_requests = 0;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_EQ(result.completed_requests, 10);
+    EXPECT_DOUBLE_EQ(result.harness_request_us, 0.0);
+    EXPECT_DOUBLE_EQ(result.harness_overhead_pct, 0.0);
+}
+
+// 固定耗时 5ms、截止时间 1ms：探测请求同样超时，预估不会被错误地调低
+TEST(BenchmarkRunnerTest, NullEngineUnreachableDeadlineHasNoGoodput) {
+    SystemMonitor monitor;
+    NullEngine engine(16, 5 * 1000 * 1000);
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 20;
+    config.warmup_rounds = 2;
+    config.deadline_ms = 1.0;
+    config.harness_calibration_requests = 0;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_GE(result.rejected_requests, 18);
+    EXPECT_EQ(result.rejected_requests + result.timeout_requests, 20);
+    EXPECT_DOUBLE_EQ(result.goodput_qps, 0.0);
+}
+
+// CancelToken 可以中止 NullEngine 的忙等；Reset 后可复用
+TEST(BenchmarkRunnerTest, NullEngineHonorsCancelToken) {
+    NullEngine engine(16, 2000 * 1000 * 1000LL); // 2s
+    std::vector<float> input(16, 1.0f);
+    CancelToken cancel;
+
+    auto begin = std::chrono::steady_clock::now();
+    std::thread canceller([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cancel.Cancel();
+    });
+    EXPECT_THROW(engine.Run(input, cancel), std::runtime_error);
+    canceller.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(1000));
+
+    NullEngine fast(16);
+    EXPECT_THROW(fast.Run(input, cancel), std::runtime_error); // 已取消的令牌
+    cancel.Reset();
+    EXPECT_EQ(fast.Run(input, cancel).size(), 1u);
+}
+
+// 预热 20ms、稳态 0.2ms、截止时间 5ms：初始预估偏高，探测请求应让准入控制恢复放行
+TEST(BenchmarkRunnerTest, AdmissionRecoversFromOverestimate) {
+    SystemMonitor monitor;
+    SlowStartEngine engine(2, 20 * 1000 * 1000, 200 * 1000);
+
+    BenchmarkConfig config;
+    config.threads = 1;
+    config.requests = 200;
+    config.warmup_rounds = 2;
+    config.deadline_ms = 5.0;
+    config.harness_calibration_requests = 0;
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+
+    EXPECT_GT(result.rejected_requests, 0);
+    EXPECT_LT(result.rejected_requests, 50);
+    EXPECT_EQ(result.rejected_requests + result.completed_requests, 200);
+    EXPECT_GT(result.goodput_qps, 0.0);
+}
+
+// 开环到达 + 截止时间：Trace 中的排队切片来自到达时刻，被拒绝的请求同样导出
+TEST(BenchmarkRunnerTest, TraceRecordsQueueWaitAndRejections) {
+    SystemMonitor monitor;
+    NullEngine engine(16, 2 * 1000 * 1000); // 2ms
+
+    BenchmarkConfig config;
+    config.threads = 1;
+    config.requests = 30;
+    config.warmup_rounds = 2;
+    config.arrival_rate = 2000.0; // 远超单 Worker 的 500 QPS，请求必然排队
+    config.deadline_ms = 10.0;
+    config.harness_calibration_requests = 0;
+    config.trace_path = "benchmark_trace_queue.json";
+
+    BenchmarkRunner runner(engine, monitor);
+    BenchmarkResult result = runner.Run(config);
+    EXPECT_GT(result.rejected_requests, 0);
+
+    std::ifstream f(config.trace_path);
+    std::string json((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    std::remove(config.trace_path.c_str());
+    EXPECT_NE(json.find("\"name\":\"queue\""), std::string::npos);
+    EXPECT_NE(json.find("\"status\":\"rejected\""), std::string::npos);
+    EXPECT_NE(json.find("\"status\":\"ok\""), std::string::npos);
+}
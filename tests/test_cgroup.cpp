@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "CgroupWatchdog.h"
+#include "FakeFileTree.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+// 辅助类：在临时目录中伪造 cgroup v2 接口文件
+class FakeCgroup : public FakeFileTree {
+public:
+    FakeCgroup() : FakeFileTree("inferbench_cgroup") {}
+};
+
+TEST(CgroupWatchdogTest, ParsesMemoryFiles) {
+    FakeCgroup fake;
+    fake.Write("memory.current", "104857600\n");
+    fake.Write("memory.max", "209715200\n");
+    fake.Write("memory.stat", "anon 73400320\nfile 31457280\nkernel 1024\n");
+    fake.Write("memory.events", "low 0\nhigh 3\nmax 2\noom 1\noom_kill 0\n");
+
+    CgroupWatchdog cgroup(fake.Path());
+    ASSERT_TRUE(cgroup.IsAvailable());
+
+    CgroupMemoryStat stat = cgroup.ReadMemoryStat();
+    EXPECT_EQ(stat.current_bytes, 104857600);
+    EXPECT_EQ(stat.max_bytes, 209715200);
+    EXPECT_EQ(stat.anon_bytes, 73400320);
+    EXPECT_EQ(stat.file_bytes, 31457280);
+    EXPECT_EQ(stat.events_high, 3);
+    EXPECT_EQ(stat.events_max, 2);
+    EXPECT_EQ(stat.events_oom, 1);
+    EXPECT_EQ(stat.events_oom_kill, 0);
+}
+
+TEST(CgroupWatchdogTest, UnlimitedMemoryMax) {
+    FakeCgroup fake;
+    fake.Write("memory.current", "4096\n");
+    fake.Write("memory.max", "max\n");
+
+    CgroupWatchdog cgroup(fake.Path());
+    EXPECT_EQ(cgroup.ReadMemoryStat().max_bytes, -1);
+}
+
+TEST(CgroupWatchdogTest, ParsesCpuStatAndQuota) {
+    FakeCgroup fake;
+    fake.Write("cpu.stat", "usage_usec 5000000\nuser_usec 4000000\nsystem_usec 1000000\n"
+                           "nr_periods 100\nnr_throttled 25\nthrottled_usec 750000\n");
+    fake.Write("cpu.max", "200000 100000\n");
+
+    CgroupWatchdog cgroup(fake.Path());
+    CgroupCpuStat stat = cgroup.ReadCpuStat();
+    EXPECT_EQ(stat.usage_usec, 5000000);
+    EXPECT_EQ(stat.nr_periods, 100);
+    EXPECT_EQ(stat.nr_throttled, 25);
+    EXPECT_EQ(stat.throttled_usec, 750000);
+    EXPECT_DOUBLE_EQ(cgroup.GetCpuQuotaCores(), 2.0);
+
+    fake.Write("cpu.max", "max 100000\n");
+    EXPECT_DOUBLE_EQ(cgroup.GetCpuQuotaCores(), 0.0);
+}
+
+TEST(CgroupWatchdogTest, UnavailableDirectory) {
+    CgroupWatchdog cgroup("/nonexistent/cgroup");
+    EXPECT_FALSE(cgroup.IsAvailable());
+    EXPECT_FALSE(cgroup.Start(WatchdogOptions(), [](const WatchdogEvent&) {}));
+    EXPECT_EQ(cgroup.ReadMemoryStat().current_bytes, 0);
+    EXPECT_DOUBLE_EQ(cgroup.GetCpuQuotaCores(), 0.0);
+}
+
+TEST(CgroupWatchdogTest, TriggersOnMemoryRatio) {
+    FakeCgroup fake;
+    fake.Write("memory.current", "950\n");
+    fake.Write("memory.max", "1000\n");
+
+    CgroupWatchdog cgroup(fake.Path());
+    WatchdogOptions options;
+    options.memory_ratio = 0.9;
+    options.poll_interval_ms = 10;
+
+    std::atomic<int> triggers(0);
+    std::atomic<int> source(-1);
+    ASSERT_TRUE(cgroup.Start(options, [&](const WatchdogEvent& event) {
+        source = static_cast<int>(event.source);
+        triggers++;
+    }));
+
+    for (int i = 0; i < 100 && triggers == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    cgroup.Stop();
+
+    EXPECT_GE(triggers.load(), 1);
+    EXPECT_EQ(source.load(), static_cast<int>(WatchdogEvent::Source::kMemoryRatio));
+}
+
+TEST(CgroupWatchdogTest, NoTriggerUnderRatio) {
+    FakeCgroup fake;
+    fake.Write("memory.current", "100\n");
+    fake.Write("memory.max", "1000\n");
+
+    CgroupWatchdog cgroup(fake.Path());
+    WatchdogOptions options;
+    options.poll_interval_ms = 10;
+
+    std::atomic<int> triggers(0);
+    ASSERT_TRUE(cgroup.Start(options, [&](const WatchdogEvent&) { triggers++; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    cgroup.Stop();
+
+    EXPECT_EQ(triggers.load(), 0);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "ColdStartRunner.h"
+#include "InferenceEngine.h"
+#include "NullEngine.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+TEST(ColdStartRunnerTest, ReloadsEngineForEveryRepetition) {
+    int loads = 0;
+    ColdStartRunner runner([&]() {
+        loads++;
+        return std::unique_ptr<Engine>(new NullEngine(16, 100 * 1000));
+    });
+
+    ColdStartConfig config;
+    config.repetitions = 3;
+    config.first_requests = 5;
+    config.idle_ms = 5;
+    ColdStartResult result = runner.Run(config);
+
+    EXPECT_EQ(loads, 3);
+    ASSERT_EQ(result.samples.size(), 3u);
+    EXPECT_EQ(result.samples[0].latencies_ms.size(), 5u);
+    EXPECT_EQ(result.samples[0].recovery_ms.size(), 5u);
+    ASSERT_EQ(result.curve_ms.size(), 5u);
+    ASSERT_EQ(result.recovery_curve_ms.size(), 5u);
+    EXPECT_GE(result.first_ms.mean, 0.1);
+    EXPECT_GE(result.recovery_first_ms.min, 0.1);
+    EXPECT_GE(result.warm_ms, 0.1);
+    EXPECT_GE(result.load_ms.max, result.load_ms.min);
+}
+
+TEST(ColdStartRunnerTest, RecoveryPhaseIsOptional) {
+    ColdStartRunner runner([]() { return std::unique_ptr<Engine>(new NullEngine(16)); });
+
+    ColdStartConfig config;
+    config.repetitions = 2;
+    config.first_requests = 3;
+    ColdStartResult result = runner.Run(config);
+
+    EXPECT_TRUE(result.samples[0].recovery_ms.empty());
+    EXPECT_TRUE(result.recovery_curve_ms.empty());
+    EXPECT_DOUBLE_EQ(result.recovery_first_ms.mean, 0.0);
+}
+
+TEST(ColdStartRunnerTest, FactoryErrorsPropagate) {
+    ColdStartRunner runner([]() -> std::unique_ptr<Engine> { throw std::runtime_error("load failed"); });
+    EXPECT_THROW(runner.Run(ColdStartConfig()), std::runtime_error);
+}
+
+TEST(ColdStartRunnerTest, SummarizeComputesSampleStatistics) {
+    ColdStartStats stats = ColdStartRunner::Summarize({1.0, 2.0, 3.0, 4.0});
+    EXPECT_DOUBLE_EQ(stats.mean, 2.5);
+    EXPECT_DOUBLE_EQ(stats.stddev, std::sqrt(5.0 / 3.0));
+    EXPECT_DOUBLE_EQ(stats.min, 1.0);
+    EXPECT_DOUBLE_EQ(stats.max, 4.0);
+
+    ColdStartStats empty = ColdStartRunner::Summarize({});
+    EXPECT_DOUBLE_EQ(empty.mean, 0.0);
+    EXPECT_DOUBLE_EQ(empty.stddev, 0.0);
+}
+
+// 换出与冲刷只影响驻留位置，不能改变内存内容
+TEST(ColdStartRunnerTest, EvictionAndFlushPreserveData) {
+    // 直接 mmap，保证是新增映射 (malloc 的大块可能复用此前其他测试释放后留下的堆空间)
+    const size_t count = 1 << 20;
+    const size_t bytes = count * sizeof(int);
+    std::vector<AddressRange> before = ColdStartRunner::SnapshotAnonymousMappings();
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(mapping, MAP_FAILED);
+    int* data = static_cast<int*>(mapping);
+    for (size_t i = 0; i < count; ++i) data[i] = static_cast<int>(i * 7);
+    std::vector<AddressRange> grown =
+        ColdStartRunner::SubtractRanges(ColdStartRunner::SnapshotAnonymousMappings(), before);
+    ASSERT_FALSE(grown.empty());
+
+    int64_t evicted = ColdStartRunner::EvictAnonymousPages(grown);
+    EXPECT_GE(evicted, -1);
+    EXPECT_LE(evicted, static_cast<int64_t>(bytes) * 2);
+    ColdStartRunner::FlushCaches(1 << 20);
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(data[i], static_cast<int>(i * 7));
+    }
+    munmap(mapping, bytes);
+}
+
+TEST(ColdStartRunnerTest, SubtractRangesKeepsOnlyGrowth) {
+    // 堆从 [0x1000, 0x3000) 增长到 0x5000，并新增了映射 [0x8000, 0x9000)
+    std::vector<AddressRange> before = {{0x1000, 0x3000}, {0x6000, 0x7000}};
+    std::vector<AddressRange> after = {{0x1000, 0x5000}, {0x6000, 0x7000}, {0x8000, 0x9000}};
+    std::vector<AddressRange> grown = ColdStartRunner::SubtractRanges(after, before);
+    ASSERT_EQ(grown.size(), 2u);
+    EXPECT_EQ(grown[0].begin, 0x3000u);
+    EXPECT_EQ(grown[0].end, 0x5000u);
+    EXPECT_EQ(grown[1].begin, 0x8000u);
+    EXPECT_EQ(grown[1].end, 0x9000u);
+
+    // 相邻映射被内核合并后，旧的部分同样要扣除
+    grown = ColdStartRunner::SubtractRanges({{0x1000, 0x7000}}, before);
+    ASSERT_EQ(grown.size(), 1u);
+    EXPECT_EQ(grown[0].begin, 0x3000u);
+    EXPECT_EQ(grown[0].end, 0x6000u);
+    EXPECT_TRUE(ColdStartRunner::SubtractRanges(before, before).empty());
+}
+
+TEST(ColdStartRunnerTest, DropFileCache) {
+    char path[] = "/tmp/inferbench_cold_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::ofstream(path) << "model bytes";
+
+    EXPECT_TRUE(ColdStartRunner::DropFileCache(path));
+    EXPECT_FALSE(ColdStartRunner::DropFileCache("non_existent_model.onnx"));
+    std::remove(path);
+}
+
+TEST(ColdStartRunnerTest, Integration) {
+    std::string model_path = "tests/resnet50.onnx";
+    std::ifstream f(model_path.c_str());
+    if (!f.good()) {
+        GTEST_SKIP() << "Skipping integration test: model not found";
+    }
+
+    ColdStartRunner runner([&]() -> std::unique_ptr<Engine> {
+        auto engine = std::make_unique<InferenceEngine>();
+        engine->LoadModel(model_path);
+        return engine;
+    }, model_path);
+
+    ColdStartConfig config;
+    config.repetitions = 2;
+    config.first_requests = 3;
+    config.evict_pages = true;
+    ColdStartResult result = runner.Run(config);
+
+    EXPECT_GT(result.load_ms.min, 0.0);
+    EXPECT_GT(result.first_ms.mean, 0.0);
+    ASSERT_EQ(result.recovery_curve_ms.size(), 3u);
+}
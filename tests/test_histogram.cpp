@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(LatencyHistogramTest, BucketsAreContiguous) {
+    // 每个桶的下界严格递增，且 BucketIndex(下界) 落回该桶
+    for (int i = 1; i < LatencyHistogram::kBucketCount; ++i) {
+        uint64_t lower = LatencyHistogram::BucketLowerBound(i);
+        EXPECT_GT(lower, LatencyHistogram::BucketLowerBound(i - 1));
+        EXPECT_EQ(LatencyHistogram::BucketIndex(lower), i);
+        EXPECT_EQ(LatencyHistogram::BucketIndex(lower - 1), i - 1);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentileWithinRelativeError) {
+    auto hist = std::make_unique<LatencyHistogram>();
+    hist->Reset();
+
+    std::mt19937 gen(42);
+    std::lognormal_distribution<double> dist(15.0, 0.5); // 约 3ms 附近的长尾分布
+    std::vector<double> samples;
+    for (int i = 0; i < 20000; ++i) {
+        uint64_t ns = static_cast<uint64_t>(dist(gen));
+        samples.push_back(ns / 1e6);
+        hist->Record(ns);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    for (double p : {0.5, 0.9, 0.99, 0.999}) {
+        double exact = samples[static_cast<size_t>(p * samples.size())];
+        EXPECT_NEAR(hist->PercentileMs(p), exact, exact * 0.02) << "p=" << p;
+    }
+    EXPECT_EQ(hist->total_count, 20000u);
+}
+
+TEST(LatencyHistogramTest, MergeCombinesCounts) {
+    auto a = std::make_unique<LatencyHistogram>();
+    auto b = std::make_unique<LatencyHistogram>();
+    a->Reset();
+    b->Reset();
+    a->Record(1000000);
+    a->Record(2000000);
+    b->Record(4000000);
+
+    a->Merge(*b);
+    EXPECT_EQ(a->total_count, 3u);
+    EXPECT_EQ(a->min_ns, 1000000u);
+    EXPECT_EQ(a->max_ns, 4000000u);
+    EXPECT_NEAR(a->MeanMs(), 7.0 / 3.0, 1e-9);
+    EXPECT_NEAR(a->PercentileMs(0.99), 4.0, 4.0 * 0.02);
+}
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    auto hist = std::make_unique<LatencyHistogram>();
+    hist->Reset();
+    EXPECT_DOUBLE_EQ(hist->PercentileMs(0.99), 0.0);
+    EXPECT_DOUBLE_EQ(hist->MeanMs(), 0.0);
+}
@@ -4,6 +4,8 @@
 #include <vector>
 #include <random>
 #include <fstream>
+#include <stdexcept>
+#include <string>
 
 TEST(InferenceEngineTest, LoadModelThrowsOnMissingFile) {
     InferenceEngine engine;
@@ -45,3 +47,64 @@ TEST(InferenceEngineTest, CanRunResNet50) {
     float sum = std::accumulate(output.begin(), output.end(), 0.0f);
     EXPECT_FALSE(std::isnan(sum));
 }
+
+TEST(InferenceEngineTest, AllocatorStatsUnavailableByDefault) {
+    InferenceEngine engine;
+    EXPECT_FALSE(engine.GetAllocatorStats().available);
+    EXPECT_EQ(engine.GetSessionMemoryBytes(), 0);
+}
+
+TEST(InferenceEngineTest, TrackingAllocatorCountsInference) {
+    std::string model_path = "tests/resnet50.onnx";
+    std::ifstream f(model_path.c_str());
+    if (!f.good()) {
+        GTEST_SKIP() << "Skipping test: resnet50.onnx not found";
+    }
+
+    InferenceEngine engine;
+    MemoryOptions memory;
+    memory.allocator = AllocatorMode::kTracking;
+    ASSERT_NO_THROW(engine.LoadModel(model_path, 99, memory));
+    EXPECT_GT(engine.GetSessionMemoryBytes(), 0);
+
+    std::vector<float> input_data(engine.GetInputSize(), 0.5f);
+    AllocatorStats before = engine.GetAllocatorStats();
+    ASSERT_TRUE(before.available);
+    engine.Run(input_data);
+    AllocatorStats after = engine.GetAllocatorStats();
+
+    // 推理的激活内存经过计数分配器，结束后释放
+    EXPECT_GT(after.total_allocated_bytes, before.total_allocated_bytes);
+    EXPECT_GE(after.peak_bytes, after.in_use_bytes);
+}
+
+// 分配器在打开模型文件之前注册，模型不存在时也能验证冲突检测
+TEST(InferenceEngineTest, ConflictingSharedAllocatorIsRejected) {
+    auto load_error = [](InferenceEngine& engine, AllocatorMode mode) {
+        MemoryOptions memory;
+        memory.allocator = mode;
+        try {
+            engine.LoadModel("non_existent_model.onnx", 99, memory);
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+
+    {
+        InferenceEngine tracking;
+        load_error(tracking, AllocatorMode::kTracking);
+
+        InferenceEngine shared;
+        EXPECT_NE(load_error(shared, AllocatorMode::kSharedArena).find("already registered"),
+                  std::string::npos);
+        InferenceEngine same;
+        EXPECT_EQ(load_error(same, AllocatorMode::kTracking).find("already registered"),
+                  std::string::npos);
+    }
+
+    // 使用者全部销毁后可以换用其他配置
+    InferenceEngine shared;
+    EXPECT_EQ(load_error(shared, AllocatorMode::kSharedArena).find("already registered"),
+              std::string::npos);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "ModelAnalyzer.h"
+#include "Roofline.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 手工编码最小的 ONNX ModelProto (protobuf wire format)，不依赖模型文件
+namespace {
+
+std::string Varint(uint64_t v) {
+    std::string out;
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+    return out;
+}
+
+std::string VarintField(int field, uint64_t v) {
+    return Varint(static_cast<uint64_t>(field) << 3) + Varint(v);
+}
+
+std::string BytesField(int field, const std::string& payload) {
+    return Varint((static_cast<uint64_t>(field) << 3) | 2) + Varint(payload.size()) + payload;
+}
+
+// dims 中的 -1 编码为 dim_param (动态维度)
+std::string ValueInfo(const std::string& name, const std::vector<int64_t>& dims) {
+    std::string shape;
+    for (int64_t d : dims) {
+        shape += BytesField(1, d < 0 ? BytesField(2, "N") : VarintField(1, d));
+    }
+    std::string tensor_type = VarintField(1, 1) + BytesField(2, shape);
+    return BytesField(1, name) + BytesField(2, BytesField(1, tensor_type));
+}
+
+std::string Initializer(const std::string& name, const std::vector<int64_t>& dims, int data_type = 1,
+                        const std::vector<int64_t>& int64_data = {}) {
+    std::string t;
+    for (int64_t d : dims) t += VarintField(1, d);
+    t += VarintField(2, data_type);
+    for (int64_t v : int64_data) t += VarintField(7, static_cast<uint64_t>(v));
+    t += BytesField(8, name);
+    return t;
+}
+
+std::string IntsAttr(const std::string& name, const std::vector<int64_t>& values) {
+    std::string a = BytesField(1, name);
+    for (int64_t v : values) a += VarintField(8, static_cast<uint64_t>(v));
+    return a + VarintField(20, 7);
+}
+
+std::string IntAttr(const std::string& name, int64_t value) {
+    return BytesField(1, name) + VarintField(3, static_cast<uint64_t>(value)) + VarintField(20, 2);
+}
+
+std::string Node(const std::string& op, const std::vector<std::string>& inputs,
+                 const std::vector<std::string>& outputs, const std::vector<std::string>& attrs = {}) {
+    std::string n;
+    for (const auto& i : inputs) n += BytesField(1, i);
+    for (const auto& o : outputs) n += BytesField(2, o);
+    n += BytesField(4, op);
+    for (const auto& a : attrs) n += BytesField(5, a);
+    return n;
+}
+
+std::string Model(const std::string& graph) {
+    return VarintField(1, 8) + BytesField(7, graph);
+}
+
+} // namespace
+
+TEST(ModelAnalyzerTest, MatMulReluCostAndLiveness) {
+    std::string graph = BytesField(1, Node("MatMul", {"X", "W"}, {"Y"})) +
+                        BytesField(1, Node("Relu", {"Y"}, {"Z"})) +
+                        BytesField(5, Initializer("W", {4, 3})) +
+                        BytesField(11, ValueInfo("X", {-1, 4})) +
+                        BytesField(12, ValueInfo("Z", {-1, 3}));
+
+    ModelCost cost = ModelAnalyzer::AnalyzeBuffer(Model(graph));
+
+    EXPECT_EQ(cost.node_count, 2);
+    EXPECT_EQ(cost.unanalyzed_nodes, 0);
+    EXPECT_EQ(cost.parameter_count, 12);
+    EXPECT_EQ(cost.parameter_bytes, 48);
+    EXPECT_DOUBLE_EQ(cost.flops, 2.0 * 1 * 3 * 4 + 3);   // MatMul + Relu
+    EXPECT_DOUBLE_EQ(cost.bytes, (16 + 48 + 12) + (12 + 12));
+    EXPECT_EQ(cost.activation_bytes, 16 + 12 + 12);      // X, Y, Z
+    EXPECT_EQ(cost.peak_activation_bytes, 16 + 12);      // X 在 MatMul 之后释放
+    ASSERT_EQ(cost.ops.size(), 2u);
+    EXPECT_EQ(cost.ops[0].op_type, "MatMul");
+}
+
+TEST(ModelAnalyzerTest, InfersConvPoolReshapeGemmShapes) {
+    std::string graph =
+        BytesField(1, Node("Conv", {"X", "W1"}, {"C"}, {IntsAttr("pads", {1, 1, 1, 1})})) +
+        BytesField(1, Node("MaxPool", {"C"}, {"P"}, {IntsAttr("kernel_shape", {2, 2}), IntsAttr("strides", {2, 2})})) +
+        BytesField(1, Node("Reshape", {"P", "shape"}, {"F"})) +
+        BytesField(1, Node("Gemm", {"F", "W2"}, {"Y"}, {IntAttr("transB", 1)})) +
+        BytesField(5, Initializer("W1", {4, 3, 3, 3})) +
+        BytesField(5, Initializer("W2", {10, 64})) +
+        BytesField(5, Initializer("shape", {2}, 7, {1, -1})) +
+        BytesField(11, ValueInfo("X", {1, 3, 8, 8})) +
+        BytesField(12, ValueInfo("Y", {1, 10}));
+
+    ModelCost cost = ModelAnalyzer::AnalyzeBuffer(Model(graph));
+
+    EXPECT_EQ(cost.unanalyzed_nodes, 0);
+    double conv = 2.0 * (4 * 8 * 8) * (3 * 3 * 3);
+    double pool = (4 * 4 * 4) * 4.0;
+    double gemm = 2.0 * 10 * 64;
+    EXPECT_DOUBLE_EQ(cost.flops, conv + pool + gemm);
+    ASSERT_FALSE(cost.ops.empty());
+    EXPECT_EQ(cost.ops[0].op_type, "Conv");
+    EXPECT_GT(cost.ArithmeticIntensity(), 0.0);
+}
+
+TEST(ModelAnalyzerTest, UnknownOpsAreCountedAsUnanalyzed) {
+    std::string graph = BytesField(1, Node("MyCustomOp", {"X"}, {"Y"})) +
+                        BytesField(1, Node("Relu", {"Y"}, {"Z"})) +
+                        BytesField(11, ValueInfo("X", {1, 4}));
+
+    ModelCost cost = ModelAnalyzer::AnalyzeBuffer(Model(graph));
+    EXPECT_EQ(cost.node_count, 2);
+    EXPECT_EQ(cost.unanalyzed_nodes, 2); // Y 的形状未知，下游 Relu 也无法估算
+    EXPECT_DOUBLE_EQ(cost.flops, 0.0);
+}
+
+TEST(ModelAnalyzerTest, AnalyzesModelFile) {
+    std::string graph = BytesField(1, Node("MatMul", {"X", "W"}, {"Y"})) +
+                        BytesField(5, Initializer("W", {4, 3})) +
+                        BytesField(11, ValueInfo("X", {-1, 4}));
+    const std::string path = "model_analyzer_test.onnx";
+    std::ofstream(path, std::ios::binary) << Model(graph);
+
+    ModelCost cost = ModelAnalyzer::Analyze(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(cost.node_count, 1);
+    EXPECT_EQ(cost.parameter_bytes, 48);
+}
+
+TEST(ModelAnalyzerTest, RejectsInvalidInput) {
+    EXPECT_THROW(ModelAnalyzer::AnalyzeBuffer(std::string("\x3a\xff\xff", 3)), std::runtime_error);
+    EXPECT_THROW(ModelAnalyzer::AnalyzeBuffer(VarintField(1, 8)), std::runtime_error); // 没有 graph
+    EXPECT_THROW(ModelAnalyzer::Analyze("non_existent_model.onnx"), std::runtime_error);
+}
+
+TEST(RooflineTest, ClassifiesMemoryAndComputeBound) {
+    MachinePeak peak;
+    peak.peak_gflops = 100.0;
+    peak.peak_bandwidth_gbs = 10.0; // 平衡点 10 FLOPs/Byte
+
+    ModelCost low_ai;
+    low_ai.flops = 2e9;
+    low_ai.bytes = 1e9;
+    RooflineReport r1 = Roofline::BuildReport(low_ai, peak, 5.0);
+    EXPECT_TRUE(r1.memory_bound);
+    EXPECT_DOUBLE_EQ(r1.ridge_point, 10.0);
+    EXPECT_DOUBLE_EQ(r1.attainable_gflops, 20.0);
+    EXPECT_DOUBLE_EQ(r1.achieved_gflops, 10.0);
+    EXPECT_DOUBLE_EQ(r1.efficiency, 0.5);
+
+    ModelCost high_ai;
+    high_ai.flops = 50e9;
+    high_ai.bytes = 1e9;
+    RooflineReport r2 = Roofline::BuildReport(high_ai, peak, 1.0);
+    EXPECT_FALSE(r2.memory_bound);
+    EXPECT_DOUBLE_EQ(r2.attainable_gflops, 100.0);
+    EXPECT_DOUBLE_EQ(r2.efficiency, 0.5);
+}
+
+TEST(RooflineTest, MeasuresPositivePeak) {
+    MachinePeak peak = Roofline::MeasureMachinePeak(1, 4u * 1024 * 1024);
+    EXPECT_EQ(peak.threads, 1);
+    EXPECT_GT(peak.peak_gflops, 0.0);
+    EXPECT_GT(peak.peak_bandwidth_gbs, 0.0);
+}
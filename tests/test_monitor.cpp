@@ -53,3 +53,13 @@ TEST(SystemMonitorTest, CpuUsageIsDynamic) {
     EXPECT_GE(v2, 0.0);
     EXPECT_LE(v2, 100.0);
 }
+
+TEST(SystemMonitorTest, HeapInUseTracksAllocations) {
+    int64_t before = SystemMonitor::GetHeapInUseBytes();
+    EXPECT_GT(before, 0);
+
+    // 大块分配走 mmap，会计入 hblkhd
+    std::vector<char> buffer(32 * 1024 * 1024, 1);
+    int64_t after = SystemMonitor::GetHeapInUseBytes();
+    EXPECT_GE(after - before, 30LL * 1024 * 1024);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "FakeFileTree.h"
+#include "PowerMonitor.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// 辅助类：在临时目录中伪造 powercap 与 cpu sysfs 接口文件
+class FakeSysfs : public FakeFileTree {
+public:
+    FakeSysfs() : FakeFileTree("inferbench_sysfs") {
+        std::filesystem::create_directories(PowercapDir());
+        std::filesystem::create_directories(CpuDir());
+    }
+    std::string PowercapDir() const { return Path() + "/powercap"; }
+    std::string CpuDir() const { return Path() + "/cpu"; }
+    std::string ProcStat() const { return Path() + "/stat"; } ///< 默认不创建：不按繁忙程度过滤
+};
+
+TEST(PowerMonitorTest, AccumulatesPackageEnergyAcrossWraparound) {
+    FakeSysfs fake;
+    fake.Write("powercap/intel-rapl:0/energy_uj", "999000000\n");
+    fake.Write("powercap/intel-rapl:0/max_energy_range_uj", "1000000000\n");
+    fake.Write("powercap/intel-rapl:0:0/energy_uj", "5000000\n"); // core 子域，不应计入
+    fake.Write("powercap/intel-rapl:1/energy_uj", "0\n");
+    fake.Write("powercap/intel-rapl:1/max_energy_range_uj", "1000000000\n");
+
+    PowerMonitor power(fake.PowercapDir(), fake.CpuDir(), fake.ProcStat(), {0, 1});
+    ASSERT_TRUE(power.HasEnergy());
+    EXPECT_FALSE(power.HasFrequency());
+    power.Begin();
+
+    fake.Write("powercap/intel-rapl:0/energy_uj", "1000000\n");   // 回绕：+2 J
+    fake.Write("powercap/intel-rapl:0:0/energy_uj", "9000000\n");
+    fake.Write("powercap/intel-rapl:1/energy_uj", "3000000\n");   // +3 J
+    power.Sample();
+    fake.Write("powercap/intel-rapl:0/energy_uj", "2000000\n");   // +1 J
+    power.End();
+    fake.Write("powercap/intel-rapl:0/energy_uj", "9000000\n");   // End() 之后，不计入
+
+    PowerSummary summary = power.Summarize();
+    EXPECT_NEAR(summary.energy_joules, 6.0, 1e-9);
+    EXPECT_GT(summary.duration_sec, 0.0);
+}
+
+TEST(PowerMonitorTest, TracksFrequencyAndBaseFrequencyDrops) {
+    FakeSysfs fake;
+    fake.Write("cpu/cpu0/cpufreq/scaling_cur_freq", "3000000\n");
+    fake.Write("cpu/cpu0/cpufreq/base_frequency", "2000000\n");
+    fake.Write("cpu/cpu1/cpufreq/scaling_cur_freq", "2000000\n");
+    fake.Write("cpu/cpufreq/ignored", "0\n"); // 非 cpuN 目录
+
+    PowerMonitor power(fake.PowercapDir(), fake.CpuDir(), fake.ProcStat(), {0, 1});
+    ASSERT_TRUE(power.HasFrequency());
+    EXPECT_FALSE(power.HasEnergy());
+    EXPECT_DOUBLE_EQ(power.GetBaseFrequencyMhz(), 2000.0);
+    power.Begin();
+
+    PowerSample s1 = power.Sample();
+    EXPECT_DOUBLE_EQ(s1.avg_freq_mhz, 2500.0);
+    EXPECT_DOUBLE_EQ(s1.min_freq_mhz, 2000.0);
+
+    fake.Write("cpu/cpu1/cpufreq/scaling_cur_freq", "1500000\n");
+    power.Sample();
+    power.Sample(); // 持续低于基础频率只计一次
+    fake.Write("cpu/cpu1/cpufreq/scaling_cur_freq", "2500000\n");
+    power.Sample();
+    fake.Write("cpu/cpu1/cpufreq/scaling_cur_freq", "1000000\n");
+    power.Sample();
+
+    PowerSummary summary = power.Summarize();
+    EXPECT_EQ(summary.below_base_events, 2);
+    EXPECT_DOUBLE_EQ(summary.min_freq_mhz, 1000.0);
+    EXPECT_DOUBLE_EQ(summary.avg_freq_mhz, (2500.0 + 2250.0 + 2250.0 + 2750.0 + 2000.0) / 5);
+}
+
+// 只统计可运行且繁忙的核：空闲核的低频不应拉低平均值或被计为跌破基础频率
+TEST(PowerMonitorTest, IgnoresIdleAndForeignCpus) {
+    FakeSysfs fake;
+    fake.Write("cpu/cpu0/cpufreq/scaling_cur_freq", "3000000\n");
+    fake.Write("cpu/cpu0/cpufreq/base_frequency", "2000000\n");
+    fake.Write("cpu/cpu1/cpufreq/scaling_cur_freq", "800000\n");  // 空闲核
+    fake.Write("cpu/cpu2/cpufreq/scaling_cur_freq", "3000000\n"); // 不在 CPU 集合内
+    fake.Write("stat", "cpu  0 0 0 0 0 0 0 0\n"
+                       "cpu0 100 0 0 100 0 0 0 0\n"
+                       "cpu1 100 0 0 100 0 0 0 0\n"
+                       "cpu2 100 0 0 100 0 0 0 0\n");
+
+    PowerMonitor power(fake.PowercapDir(), fake.CpuDir(), fake.ProcStat(), {0, 1});
+    power.Begin();
+
+    // cpu0 繁忙 90%，cpu1 繁忙 10%
+    fake.Write("stat", "cpu  0 0 0 0 0 0 0 0\n"
+                       "cpu0 180 0 10 110 0 0 0 0\n"
+                       "cpu1 105 0 5 190 0 0 0 0\n"
+                       "cpu2 200 0 0 100 0 0 0 0\n");
+    PowerSample busy = power.Sample();
+    EXPECT_DOUBLE_EQ(busy.avg_freq_mhz, 3000.0);
+    EXPECT_DOUBLE_EQ(busy.min_freq_mhz, 3000.0);
+
+    // 两个核都空闲：该次采样不计入
+    fake.Write("stat", "cpu  0 0 0 0 0 0 0 0\n"
+                       "cpu0 180 0 10 210 0 0 0 0\n"
+                       "cpu1 105 0 5 290 0 0 0 0\n"
+                       "cpu2 200 0 0 200 0 0 0 0\n");
+    EXPECT_DOUBLE_EQ(power.Sample().avg_freq_mhz, 0.0);
+
+    PowerSummary summary = power.Summarize();
+    EXPECT_EQ(summary.below_base_events, 0);
+    EXPECT_DOUBLE_EQ(summary.avg_freq_mhz, 3000.0);
+    EXPECT_DOUBLE_EQ(summary.min_freq_mhz, 3000.0);
+}
+
+TEST(PowerMonitorTest, CountsPackageThrottleOncePerPackage) {
+    FakeSysfs fake;
+    for (int cpu = 0; cpu < 2; ++cpu) {
+        std::string base = "cpu/cpu" + std::to_string(cpu);
+        fake.Write(base + "/thermal_throttle/core_throttle_count", "1\n");
+        fake.Write(base + "/thermal_throttle/package_throttle_count", "10\n");
+        fake.Write(base + "/topology/physical_package_id", "0\n");
+    }
+
+    PowerMonitor power(fake.PowercapDir(), fake.CpuDir(), fake.ProcStat(), {0, 1});
+    ASSERT_TRUE(power.HasThrottleCounters());
+    power.Begin();
+
+    fake.Write("cpu/cpu0/thermal_throttle/core_throttle_count", "3\n");
+    fake.Write("cpu/cpu0/thermal_throttle/package_throttle_count", "14\n");
+    fake.Write("cpu/cpu1/thermal_throttle/package_throttle_count", "14\n");
+
+    EXPECT_EQ(power.Summarize().throttle_events, 2 + 4);
+}
+
+TEST(PowerMonitorTest, MissingInterfacesYieldZeros) {
+    FakeSysfs fake;
+    PowerMonitor power(fake.PowercapDir(), fake.CpuDir(), fake.ProcStat(), {0, 1});
+    EXPECT_FALSE(power.HasEnergy());
+    EXPECT_FALSE(power.HasFrequency());
+    EXPECT_FALSE(power.HasThrottleCounters());
+    EXPECT_DOUBLE_EQ(power.GetBaseFrequencyMhz(), 0.0);
+
+    power.Begin();
+    power.Sample();
+    PowerSummary summary = power.Summarize();
+    EXPECT_DOUBLE_EQ(summary.energy_joules, 0.0);
+    EXPECT_DOUBLE_EQ(summary.avg_freq_mhz, 0.0);
+    EXPECT_EQ(summary.throttle_events, 0);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "ProcessRunner.h"
+#include <fstream>
+#include <iostream>
+
+TEST(ProcessRunnerTest, ThrowsWhenWorkersFailToLoad) {
+    SystemMonitor monitor;
+    ProcessRunner runner("non_existent_model.onnx", 99, monitor);
+
+    BenchmarkConfig config;
+    config.processes = 2;
+    config.requests = 10;
+    EXPECT_THROW(runner.Run(config), std::runtime_error);
+}
+
+TEST(ProcessRunnerTest, Integration) {
+    std::string model_path = "tests/resnet50.onnx";
+    std::ifstream f(model_path.c_str());
+    if (!f.good()) {
+        GTEST_SKIP() << "Skipping integration test: model not found";
+    }
+
+    SystemMonitor monitor;
+    ProcessRunner runner(model_path, 99, monitor);
+
+    BenchmarkConfig config;
+    config.processes = 2;
+    config.requests = 20;
+    config.warmup_rounds = 2;
+
+    BenchmarkResult result = runner.Run(config);
+    std::cout << "Process Mode QPS: " << result.qps << std::endl;
+
+    EXPECT_EQ(result.completed_requests, 20);
+    EXPECT_GT(result.qps, 0.0);
+    EXPECT_GT(result.avg_latency_ms, 0.0);
+    EXPECT_GE(result.p99_latency_ms, result.avg_latency_ms * 0.5);
+    EXPECT_GT(result.peak_memory_mb, 0.0);
+}
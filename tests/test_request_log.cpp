@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "RequestLog.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <dirent.h>
+#include <sys/resource.h>
+
+TEST(RequestLogTest, RoundTripMultipleWorkers) {
+    const std::string path = "request_log_test.bin";
+    const int workers = 4;
+    const int per_worker = 1000;
+    {
+        // 缓冲区设得很小，确保经过多轮 Submit / 后台刷盘
+        RequestLogWriter writer(path, workers, 123456789ull, 64);
+        std::vector<std::thread> threads;
+        for (int w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w]() {
+                for (int i = 0; i < per_worker; ++i) {
+                    writer.Append(w, {static_cast<uint64_t>(i), static_cast<uint64_t>(1000 + i),
+                                      static_cast<uint32_t>(w), 0, kRequestOk});
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        writer.Close();
+        EXPECT_EQ(writer.GetRecordCount(), static_cast<uint64_t>(workers * per_worker));
+    }
+
+    RequestLogReader reader;
+    ASSERT_NO_THROW(reader.Open(path));
+    EXPECT_EQ(reader.GetHeader().start_unix_ns, 123456789ull);
+    ASSERT_EQ(reader.size(), static_cast<size_t>(workers * per_worker));
+
+    // 每个 Worker 的记录都完整且按顺序出现
+    std::vector<int> next(workers, 0);
+    for (size_t i = 0; i < reader.size(); ++i) {
+        const RequestLogRecord& r = reader[i];
+        ASSERT_LT(r.worker, static_cast<uint32_t>(workers));
+        EXPECT_EQ(r.timestamp_ns, static_cast<uint64_t>(next[r.worker]));
+        EXPECT_EQ(r.latency_ns, static_cast<uint64_t>(1000 + next[r.worker]));
+        next[r.worker]++;
+    }
+    for (int w = 0; w < workers; ++w) EXPECT_EQ(next[w], per_worker);
+
+    // 关闭后文件被截断到实际大小
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(static_cast<size_t>(f.tellg()),
+              sizeof(RequestLogHeader) + reader.size() * sizeof(RequestLogRecord));
+    std::remove(path.c_str());
+}
+
+TEST(RequestLogTest, ExportsCsvAndColumns) {
+    const std::string path = "request_log_export.bin";
+    {
+        RequestLogWriter writer(path, 1, 0);
+        writer.Append(0, {10, 2000, 0, 1, kRequestOk});
+        writer.Append(0, {20, 3000, 0, 2, kRequestError});
+    }
+
+    RequestLogReader reader;
+    reader.Open(path);
+    ASSERT_TRUE(reader.ExportCsv("request_log_export.csv"));
+    ASSERT_TRUE(reader.ExportColumns("request_log_export"));
+
+    std::ifstream csv("request_log_export.csv");
+    std::string header, row1, row2;
+    std::getline(csv, header);
+    std::getline(csv, row1);
+    std::getline(csv, row2);
+    EXPECT_EQ(header, "timestamp_ns,latency_ns,worker,shape_bucket,status");
+    EXPECT_EQ(row1, "10,2000,0,1,0");
+    EXPECT_EQ(row2, "20,3000,0,2,1");
+
+    std::ifstream col("request_log_export.latency_ns.u64", std::ios::binary);
+    uint64_t values[2] = {0, 0};
+    col.read(reinterpret_cast<char*>(values), sizeof(values));
+    EXPECT_EQ(values[0], 2000u);
+    EXPECT_EQ(values[1], 3000u);
+
+    for (const char* suffix : {".bin", ".csv", ".timestamp_ns.u64", ".latency_ns.u64", ".worker.u32",
+                               ".shape_bucket.u16", ".status.u16"}) {
+        std::remove((std::string("request_log_export") + suffix).c_str());
+    }
+}
+
+TEST(RequestLogTest, RejectsInvalidFile) {
+    const std::string path = "request_log_invalid.bin";
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << std::string(128, 'x');
+    }
+    RequestLogReader reader;
+    EXPECT_THROW(reader.Open(path), std::runtime_error);
+    EXPECT_THROW(reader.Open("non_existent_log.bin"), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// /dev/full 可以打开但无法预留空间：构造函数抛异常时不能泄漏文件描述符
+TEST(RequestLogTest, FailedConstructionClosesFile) {
+    auto count_fds = []() {
+        int count = 0;
+        if (DIR* d = opendir("/proc/self/fd")) {
+            while (readdir(d)) count++;
+            closedir(d);
+        }
+        return count;
+    };
+
+    int before = count_fds();
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_THROW(RequestLogWriter("/dev/full", 1, 0), std::runtime_error);
+    }
+    EXPECT_EQ(count_fds(), before);
+}
+
+// 空间不足时 (此处用 RLIMIT_FSIZE 模拟) 丢弃放不下的批次，已写入的记录保持有效，进程不会收到 SIGBUS
+TEST(RequestLogTest, DropsBatchesWhenSpaceRunsOut) {
+    const std::string path = "request_log_full.bin";
+    const uint64_t limit_bytes = 256 * 1024;
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = saved;
+    limited.rlim_cur = limit_bytes;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+
+    uint64_t written = 0;
+    {
+        RequestLogWriter writer(path, 1, 0, 256);
+        for (int i = 0; i < 50000; ++i) {
+            writer.Append(0, {static_cast<uint64_t>(i), 1, 0, 0, kRequestOk});
+        }
+        writer.Close();
+        written = writer.GetRecordCount();
+    }
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, old_handler);
+
+    EXPECT_GT(written, 0u);
+    EXPECT_LT(written, 50000u);
+    RequestLogReader reader;
+    ASSERT_NO_THROW(reader.Open(path));
+    ASSERT_EQ(reader.size(), written);
+    // 放得下的批次完整保留 (被丢弃的批次之后，较小的尾批次仍可能写入)
+    EXPECT_EQ(reader[0].timestamp_ns, 0u);
+    for (size_t i = 1; i < reader.size(); ++i) {
+        ASSERT_GT(reader[i].timestamp_ns, reader[i - 1].timestamp_ns);
+    }
+    std::remove(path.c_str());
+}
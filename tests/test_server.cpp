@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "InferenceEngine.h"
+#include "InferenceServer.h"
+#include "NullEngine.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// 连接 unix socket 并发出一个请求，之后不读取响应 (模拟卡住的客户端)
+int ConnectAndSendWithoutReading(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    int rcvbuf = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    float input[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    ServingRequestHeader header{kServingRequestMagic, sizeof(input), 1};
+    send(fd, &header, sizeof(header), MSG_NOSIGNAL);
+    send(fd, input, sizeof(input), MSG_NOSIGNAL);
+    return fd;
+}
+
+} // namespace
+
+TEST(InferenceServerTest, RejectsInvalidEndpoint) {
+    InferenceEngine engine;
+    InferenceServer server(engine);
+    EXPECT_THROW(server.Start("http://127.0.0.1:8080", 1), std::runtime_error);
+    EXPECT_THROW(server.Start("tcp:127.0.0.1", 1), std::runtime_error);
+    EXPECT_THROW(server.Start("tcp:not-an-ip:0", 1), std::runtime_error);
+}
+
+TEST(InferenceServerTest, ClientFailsWithoutServer) {
+    std::string path = "/tmp/inferbench_test_" + std::to_string(getpid()) + ".sock";
+    LoadClient client("unix:" + path);
+    BenchmarkConfig config;
+    EXPECT_THROW(client.Run(config, 4), std::runtime_error);
+}
+
+TEST(InferenceServerTest, TcpPortZeroResolvesToBoundPort) {
+    InferenceEngine engine;
+    InferenceServer server(engine);
+    server.Start("tcp:127.0.0.1:0", 1);
+    EXPECT_NE(server.GetEndpoint(), "tcp:127.0.0.1:0");
+    EXPECT_EQ(server.GetEndpoint().compare(0, 14, "tcp:127.0.0.1:"), 0);
+    server.Stop();
+    server.Stop(); // 可重复调用
+}
+
+TEST(InferenceServerTest, EngineErrorsAreReportedPerRequest) {
+    // 未加载模型的引擎对每个请求都会抛出异常，服务端应返回失败状态而不断开连接
+    std::string path = "/tmp/inferbench_test_" + std::to_string(getpid()) + ".sock";
+    InferenceEngine engine;
+    InferenceServer server(engine);
+    server.Start("unix:" + path, 2);
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 20;
+    config.warmup_rounds = 0;
+    LoadClient client(server.GetEndpoint());
+    ServingResult result = client.Run(config, 4);
+    server.Stop();
+
+    EXPECT_EQ(result.completed_requests, 0);
+    EXPECT_EQ(result.failed_requests, 20);
+    EXPECT_NE(access(path.c_str(), F_OK), 0); // Stop 后 socket 文件被清理
+}
+
+TEST(InferenceServerTest, Integration) {
+    std::string model_path = "tests/resnet50.onnx";
+    std::ifstream f(model_path.c_str());
+    if (!f.good()) {
+        GTEST_SKIP() << "Skipping integration test: model not found";
+    }
+
+    InferenceEngine engine;
+    engine.LoadModel(model_path);
+    InferenceServer server(engine);
+    server.Start("tcp:127.0.0.1:0", 2);
+
+    BenchmarkConfig config;
+    config.threads = 2;
+    config.requests = 20;
+    config.warmup_rounds = 2;
+    LoadClient client(server.GetEndpoint());
+    ServingResult result = client.Run(config, engine.GetInputSize());
+    server.Stop();
+    std::cout << "Serving Mode QPS: " << result.qps << std::endl;
+
+    EXPECT_EQ(result.completed_requests, 20);
+    EXPECT_GT(result.qps, 0.0);
+    EXPECT_GT(result.infer_avg_ms, 0.0);
+    EXPECT_GE(result.e2e_avg_ms, result.infer_avg_ms);
+    EXPECT_GE(result.network_avg_ms, 0.0);
+}
+
+// 输出 64 MiB 的引擎：单个响应远大于 socket 缓冲区，客户端不读时 Worker 会卡在写出上
+TEST(InferenceServerTest, StalledClientIsDisconnected) {
+    std::string path = "/tmp/inferbench_test_" + std::to_string(getpid()) + ".sock";
+    NullEngine engine(4, 0, 16 * 1024 * 1024);
+    InferenceServer server(engine, 200);
+    server.Start("unix:" + path, 1);
+
+    int fd = ConnectAndSendWithoutReading(path);
+    ASSERT_GE(fd, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    // 写超时后服务端关闭连接：读完已缓冲的部分后应遇到 EOF，而不是一直有数据
+    timeval tv{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::vector<char> chunk(64 * 1024);
+    size_t received = 0;
+    ssize_t n;
+    while ((n = recv(fd, chunk.data(), chunk.size(), 0)) > 0) {
+        received += static_cast<size_t>(n);
+    }
+    close(fd);
+    EXPECT_EQ(n, 0);
+    EXPECT_LT(received, sizeof(ServingResponseHeader) + 16u * 1024 * 1024 * sizeof(float));
+    server.Stop();
+}
+
+TEST(InferenceServerTest, StopDoesNotWaitForStalledClient) {
+    std::string path = "/tmp/inferbench_test_" + std::to_string(getpid()) + ".sock";
+    NullEngine engine(4, 0, 16 * 1024 * 1024);
+    InferenceServer server(engine, 60 * 1000);
+    server.Start("unix:" + path, 1);
+
+    int fd = ConnectAndSendWithoutReading(path);
+    ASSERT_GE(fd, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    auto start = std::chrono::steady_clock::now();
+    server.Stop();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    close(fd);
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+}
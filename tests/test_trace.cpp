@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "TraceRecorder.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string ReadAll(const std::string& path) {
+    std::ifstream f(path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+size_t CountOccurrences(const std::string& haystack, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+RequestSpan MakeSpan(int worker, int64_t id) {
+    RequestSpan span;
+    span.request_id = id;
+    span.worker = worker;
+    span.start_ns = id * 1000000;
+    span.queue_ns = 1000;
+    span.infer_ns = 500000;
+    span.post_ns = 2000;
+    return span;
+}
+
+} // namespace
+
+TEST(TraceRecorderTest, ExportsSpansAndCounters) {
+    TraceRecorder recorder(2, 16);
+    recorder.Record(MakeSpan(0, 0));
+    recorder.Record(MakeSpan(1, 1));
+    recorder.AddCounter("cpu_usage_pct", 0, 42.0);
+
+    std::string path = "trace_test_output.json";
+    ASSERT_TRUE(recorder.ExportChromeTrace(path));
+    std::string json = ReadAll(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"request\""), 2u);
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"inference\""), 2u);
+    EXPECT_NE(json.find("\"name\":\"cpu_usage_pct\",\"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"worker 1\""), std::string::npos);
+    // 最后一个事件后不能有多余的逗号
+    EXPECT_NE(json.find("}}\n]}"), std::string::npos);
+    EXPECT_EQ(recorder.GetDroppedCount(), 0u);
+}
+
+TEST(TraceRecorderTest, RingBufferKeepsLatestSpans) {
+    TraceRecorder recorder(1, 4);
+    for (int64_t i = 0; i < 10; ++i) {
+        recorder.Record(MakeSpan(0, i));
+    }
+    EXPECT_EQ(recorder.GetDroppedCount(), 6u);
+
+    std::string path = "trace_ring_output.json";
+    ASSERT_TRUE(recorder.ExportChromeTrace(path));
+    std::string json = ReadAll(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"request\""), 4u);
+    EXPECT_EQ(json.find("\"id\":5,"), std::string::npos);
+    EXPECT_NE(json.find("\"id\":6,"), std::string::npos);
+    EXPECT_NE(json.find("\"id\":9,"), std::string::npos);
+}
+
+TEST(TraceRecorderTest, ThreadUsageIsMonotonic) {
+    ThreadUsage before = ThreadUsage::Capture();
+    std::vector<char> buffer(8 * 1024 * 1024, 1); // 触发缺页
+    ThreadUsage after = ThreadUsage::Capture();
+    EXPECT_GE(after.minor_faults, before.minor_faults);
+    EXPECT_GE(after.voluntary_ctx_switches, before.voluntary_ctx_switches);
+}
+
+TEST(TraceRecorderTest, ExportsQueueAndRejectedSpans) {
+    TraceRecorder recorder(1, 16);
+    RequestSpan served = MakeSpan(0, 0);
+    served.dispatch_ns = 3000;
+    recorder.Record(served);
+
+    RequestSpan rejected;
+    rejected.request_id = 1;
+    rejected.start_ns = 5000000;
+    rejected.queue_ns = 800000;
+    rejected.status = 2; // kRequestRejected
+    recorder.Record(rejected);
+
+    std::string path = "trace_status_output.json";
+    ASSERT_TRUE(recorder.ExportChromeTrace(path));
+    std::string json = ReadAll(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"request\""), 2u);
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"queue\""), 2u);
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"dispatch\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"inference\""), 1u); // 被拒绝的请求没有推理切片
+    EXPECT_NE(json.find("\"status\":\"ok\""), std::string::npos);
+    EXPECT_NE(json.find("\"status\":\"rejected\""), std::string::npos);
+    // 推理切片紧接在排队与派发之后：0 + 1us + 3us
+    EXPECT_NE(json.find("\"name\":\"inference\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":4.000"),
+              std::string::npos);
+}